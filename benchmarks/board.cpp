@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+
+#include "board.hpp"
+#include "features.hpp"
+#include "fixtures.hpp"
+#include "tetriminoes.hpp"
+
+namespace {
+
+constexpr auto rotations = std::array{
+    geom::Rotation::R0,
+    geom::Rotation::R90,
+    geom::Rotation::R180,
+    geom::Rotation::R270,
+};
+
+// Test every tetrimino in every rotation at every position of a midgame
+// board.
+void board_piece_fits(benchmark::State& state)
+{
+    auto const game = benchmarks::midgame(2000);
+    auto const& board = game.board();
+    auto tests = std::int64_t{0};
+
+    for (auto _: state) {
+        for (auto const& tetrimino: tetris::tetriminoes) {
+            for (auto rotation: rotations) {
+                for (auto row = -2; row < tetris::Board::rows; ++row) {
+                    for (auto column = -2; column < tetris::Board::columns;
+                         ++column) {
+                        benchmark::DoNotOptimize(board.piece_fits(
+                            tetrimino,
+                            {row, column},
+                            rotation));
+                        ++tests;
+                    }
+                }
+            }
+        }
+    }
+
+    state.SetItemsProcessed(tests);
+}
+
+// Lock a tetrimino at the bottom of an empty board.
+void board_lock(benchmark::State& state)
+{
+    auto const empty = tetris::Board{};
+    auto const& tetrimino = tetris::tetriminoes[0];
+
+    for (auto _: state) {
+        auto board = empty;
+        board.lock(tetrimino, {tetris::Board::rows - 4, 0}, geom::Rotation::R0);
+        benchmark::DoNotOptimize(board);
+    }
+}
+
+// Find, mark and remove four full lines, as happens after a tetris.
+void board_clear_lines(benchmark::State& state)
+{
+    // Stand an I in every column, its blocks covering the bottom four rows.
+    auto const& i = tetris::tetriminoes[0];
+    auto const& layout = i.layout(geom::Rotation::R90);
+    auto full = tetris::Board{};
+
+    for (auto column = 0; column < tetris::Board::columns; ++column) {
+        full.lock(
+            i,
+            {tetris::Board::rows - 4 - layout.min.row,
+             column - layout.min.column},
+            geom::Rotation::R90);
+    }
+
+    for (auto _: state) {
+        auto board = full;
+        auto rows = board.full_rows();
+        board.fill_rows(rows, tetris::BlockType::Line);
+        board.collapse_rows(rows);
+        benchmark::DoNotOptimize(board);
+    }
+}
+
+// All heuristic features of a midgame board.
+void board_features(benchmark::State& state)
+{
+    auto const game = benchmarks::midgame(2000);
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(tetris::compute_features(game.board()));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+}
+
+BENCHMARK(board_piece_fits);
+BENCHMARK(board_lock);
+BENCHMARK(board_clear_lines);
+BENCHMARK(board_features);
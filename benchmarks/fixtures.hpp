@@ -0,0 +1,63 @@
+#ifndef BENCHMARKS_FIXTURES_HPP
+#define BENCHMARKS_FIXTURES_HPP
+
+#include <cstdint>
+
+#include "rng.hpp"
+#include "tetris.hpp"
+
+// Reproducible inputs shared by the benchmarks. Every seed is fixed, so runs
+// of the same commit do the same work and results can be diffed.
+
+namespace benchmarks {
+
+constexpr auto game_seed = tetris::Rng::Seed{20200601};
+constexpr auto input_seed = std::uint32_t{4242};
+
+// Random inputs from `Left` through `Nothing`, with `Nothing` as likely as
+// the four others together so that pieces get to fall. Draws go through
+// `bounded_rand`, so the stream is the same with every standard library.
+class InputStream {
+public:
+    explicit InputStream(std::uint32_t seed): engine_{seed} {}
+
+    tetris::Input next()
+    {
+        constexpr auto nothing =
+            static_cast<std::uint32_t>(tetris::Input::Nothing);
+
+        // Values from `nothing` up all stand for `Nothing`.
+        auto value = tetris::bounded_rand(engine_, 2 * nothing);
+
+        if (value >= nothing) {
+            return tetris::Input::Nothing;
+        }
+
+        return static_cast<tetris::Input>(value);
+    }
+
+private:
+    tetris::Pcg32 engine_;
+};
+
+// A game played with random inputs for a while, so that its board has some
+// blocks in it. Starts over if the game ends before then.
+inline tetris::Tetris midgame(int ticks)
+{
+    auto game = tetris::Tetris{tetris::Rng{game_seed}};
+    auto inputs = InputStream{input_seed};
+
+    for (auto tick = 0; tick < ticks; ++tick) {
+        if (game.is_over()) {
+            game = tetris::Tetris{tetris::Rng{game_seed + 1}};
+        }
+
+        game.advance(inputs.next());
+    }
+
+    return game;
+}
+
+}
+
+#endif
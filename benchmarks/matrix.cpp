@@ -0,0 +1,38 @@
+#include <benchmark/benchmark.h>
+
+#include "matrix.hpp"
+
+namespace {
+
+// Read every element of a board-sized matrix under a rotation.
+void matrix_read(benchmark::State& state)
+{
+    using Matrix = geom::Matrix2D<int, 20, 20>;
+
+    auto contents = Matrix::ContentArray{};
+
+    for (auto i = std::size_t{0}; i < contents.size(); ++i) {
+        contents[i] = static_cast<int>(i);
+    }
+
+    auto const matrix = Matrix{contents};
+    auto rotation = static_cast<geom::Rotation>(state.range(0));
+
+    for (auto _: state) {
+        auto sum = 0;
+
+        for (auto row = 0; row < 20; ++row) {
+            for (auto column = 0; column < 20; ++column) {
+                sum += matrix[{{row, column}, rotation}];
+            }
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 20 * 20);
+}
+
+}
+
+BENCHMARK(matrix_read)->DenseRange(0, 3)->ArgName("rotation");
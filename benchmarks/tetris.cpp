@@ -0,0 +1,118 @@
+#include <benchmark/benchmark.h>
+
+#include "agent.hpp"
+#include "fixtures.hpp"
+#include "placements.hpp"
+#include "tetris.hpp"
+
+namespace {
+
+// Single ticks with random inputs, restarting from a snapshot when the game
+// ends.
+void tetris_advance(benchmark::State& state)
+{
+    auto game = benchmarks::midgame(500);
+    auto const start = game.save();
+    auto inputs = benchmarks::InputStream{benchmarks::input_seed};
+
+    for (auto _: state) {
+        if (game.is_over()) {
+            game.restore(start);
+        }
+
+        game.advance(inputs.next());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Whole games with random inputs, from the first tick to game over.
+template <typename Rules> void tetris_random_game(benchmark::State& state)
+{
+    auto seed = benchmarks::game_seed;
+    auto ticks = std::int64_t{0};
+
+    for (auto _: state) {
+        auto game = tetris::BasicTetris<Rules>{tetris::Rng{seed++}};
+        auto inputs = benchmarks::InputStream{benchmarks::input_seed};
+
+        while (not game.is_over()) {
+            game.advance(inputs.next());
+            ++ticks;
+        }
+    }
+
+    state.counters["ticks"] = benchmark::Counter(
+        static_cast<double>(ticks),
+        benchmark::Counter::kIsRate);
+}
+
+// Whole games placing each piece in one call at a pseudo-random column.
+void tetris_place_game(benchmark::State& state)
+{
+    auto seed = benchmarks::game_seed;
+    auto pieces = std::int64_t{0};
+
+    for (auto _: state) {
+        auto game = tetris::Tetris{tetris::Rng{seed++}};
+        auto column = 0;
+
+        while (not game.is_over()) {
+            column = (column + 3) % tetris::Board::columns;
+
+            if (not game.place(column - 1, geom::Rotation::R0)) {
+                game.place(
+                    game.falling_tetrimino().position.column,
+                    game.falling_tetrimino().rotation);
+            }
+
+            ++pieces;
+        }
+    }
+
+    state.SetItemsProcessed(pieces);
+}
+
+// Games played by the agent, looking one tetrimino ahead. Games are cut
+// short, as the agent rarely loses.
+void agent_game(benchmark::State& state)
+{
+    auto seed = benchmarks::game_seed;
+    auto pieces = std::int64_t{0};
+    auto agent = tetris::Agent{};
+
+    for (auto _: state) {
+        auto game = tetris::Tetris{tetris::Rng{seed++}};
+
+        for (auto placed = 0; placed < 100 and agent.play(game); ++placed) {
+            ++pieces;
+        }
+    }
+
+    state.SetItemsProcessed(pieces);
+}
+
+// Every lock position of the falling tetrimino on a midgame board.
+void placement_finder(benchmark::State& state)
+{
+    auto const game = benchmarks::midgame(2000);
+    auto finder = tetris::PlacementFinder{};
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(
+            finder.find(game.board(), game.falling_tetrimino()).size());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+}
+
+BENCHMARK(tetris_advance);
+BENCHMARK_TEMPLATE(tetris_random_game, tetris::StandardRules);
+BENCHMARK_TEMPLATE(tetris_random_game, tetris::TallRules);
+BENCHMARK_TEMPLATE(tetris_random_game, tetris::CompactRules);
+BENCHMARK_TEMPLATE(tetris_random_game, tetris::ModernRules);
+BENCHMARK(tetris_place_game);
+BENCHMARK(placement_finder);
+BENCHMARK(agent_game);
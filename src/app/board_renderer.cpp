@@ -0,0 +1,105 @@
+#include "board_renderer.hpp"
+
+cursespp::Character board_character(tetris::BlockType type)
+{
+    return static_cast<cursespp::Character>(
+        " IOSZLJT="[static_cast<std::size_t>(type)]);
+}
+
+bool init_block_colors(cursespp::Curses& curses)
+{
+    if (not curses.has_colors()) {
+        return false;
+    }
+
+    curses.start_color();
+
+    // Pair `n` is used by block type `n`; the empty type (0) keeps the
+    // terminal's default pair.
+    constexpr short foregrounds[] = {
+        COLOR_CYAN,
+        COLOR_YELLOW,
+        COLOR_GREEN,
+        COLOR_RED,
+        COLOR_WHITE,
+        COLOR_BLUE,
+        COLOR_MAGENTA,
+        COLOR_WHITE,
+    };
+
+    for (auto i = 0; i < 8; ++i) {
+        curses.init_pair(
+            static_cast<short>(i + 1),
+            foregrounds[i],
+            COLOR_BLACK);
+    }
+
+    return true;
+}
+
+cursespp::Character BoardRenderer::block_character(
+    tetris::BlockType type) const
+{
+    auto character = board_character(type);
+
+    if (colors_ and type != tetris::BlockType::Empty) {
+        character |= cursespp::color_pair(static_cast<short>(type)) |
+                     A_REVERSE;
+    }
+
+    return character;
+}
+
+template <typename Game>
+bool BoardRenderer::draw_game(cursespp::Window& window, Game& game)
+{
+    auto dirty = game.dirty_rows();
+
+    if (not dirty) {
+        return false;
+    }
+
+    auto const& board = game.board();
+    auto const& falling = game.falling_tetrimino();
+    auto const& layout = falling.tetrimino().layout(falling.rotation);
+    auto falling_character = block_character(falling.tetrimino().type());
+
+    for (auto r = 0; r < tetris::Board::rows; ++r) {
+        if (not(dirty & (tetris::Board::RowSet{1} << r))) {
+            continue;
+        }
+
+        for (auto c = 0; c < tetris::Board::columns; ++c) {
+            auto character = block_character(board[{r, c}]);
+            line_[static_cast<std::size_t>(2 * c)] = character;
+            line_[static_cast<std::size_t>(2 * c + 1)] = character;
+        }
+
+        for (auto const& block: layout.blocks) {
+            auto position = falling.position + block;
+
+            if (position.row == r) {
+                auto c = static_cast<std::size_t>(position.column);
+                line_[2 * c] = falling_character;
+                line_[2 * c + 1] = falling_character;
+            }
+        }
+
+        window.move_add_chars(offset_.row + r, offset_.column, line_);
+    }
+
+    game.clear_dirty_rows();
+    return true;
+}
+
+bool BoardRenderer::draw(cursespp::Window& window, tetris::Tetris& game)
+{
+    return draw_game(window, game);
+}
+
+bool BoardRenderer::draw(
+    cursespp::Window& window,
+    tetris::BroadcastViewer& viewer)
+{
+    return draw_game(window, viewer);
+}
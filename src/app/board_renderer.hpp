@@ -0,0 +1,65 @@
+#ifndef APP_BOARD_RENDERER_HPP
+#define APP_BOARD_RENDERER_HPP
+
+#include <array>
+
+#include "board.hpp"
+#include "broadcast.hpp"
+#include "cursespp.hpp"
+#include "matrix.hpp"
+#include "tetris.hpp"
+
+// Map block types to curses characters.
+//
+// Args:
+//     type: The type of the block to be rendered.
+// Returns:
+//     A character representing such block.
+cursespp::Character board_character(tetris::BlockType type);
+
+// Set up one colour pair per block type, for `BoardRenderer` to draw with.
+//
+// Returns:
+//     Whether the terminal supports colours, i.e. whether the pairs were set.
+bool init_block_colors(cursespp::Curses& curses);
+
+// Draws a game's board with its falling tetrimino, two characters per block.
+//
+// Only the rows the game reports as dirty are redrawn, each with a single
+// curses call.
+class BoardRenderer {
+public:
+    // Args:
+    //     colors: Whether to colour blocks, see `init_block_colors`.
+    //     offset: Window position of the board's top-left block.
+    explicit BoardRenderer(bool colors, geom::Position offset = {1, 1}):
+        colors_{colors}, offset_{offset}
+    {}
+
+    // Redraw the rows of a game that changed since the last draw.
+    //
+    // Args:
+    //     window: The window to draw to.
+    //     game: The game to draw. Its dirty rows are cleared.
+    //
+    // Returns:
+    //     Whether anything was drawn, i.e. whether the window needs a
+    //     refresh.
+    bool draw(cursespp::Window& window, tetris::Tetris& game);
+
+    // Redraw the rows of a broadcast game that changed since the last draw.
+    bool draw(cursespp::Window& window, tetris::BroadcastViewer& viewer);
+
+private:
+    // Either `draw`: `Game` is `tetris::Tetris` or `tetris::BroadcastViewer`.
+    template <typename Game>
+    bool draw_game(cursespp::Window& window, Game& game);
+
+    cursespp::Character block_character(tetris::BlockType type) const;
+
+    bool colors_;
+    geom::Position offset_;
+    std::array<cursespp::Character, 2 * tetris::Board::columns> line_;
+};
+
+#endif
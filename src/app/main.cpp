@@ -1,80 +1,118 @@
 #include <chrono>
+#include <cstdint>
+#include <fstream>
 #include <iostream>
 #include <optional>
 #include <random>
-#include <thread>
-#include <variant>
+#include <string_view>
+#include <system_error>
 
+#include <unistd.h>
+
+#include "agent.hpp"
 #include "assert.hpp"
-#include "block_type.hpp"
-#include "board.hpp"
+#include "board_renderer.hpp"
+#include "broadcast.hpp"
 #include "cursespp.hpp"
-#include "matrix.hpp"
-#include "tetriminoes.hpp"
+#include "frame_timings.hpp"
+#include "input_waiter.hpp"
 #include "tetris.hpp"
+#include "thread_pool.hpp"
+#include "tick_clock.hpp"
 
-// Map block types to curses characters.
-//
-// Args:
-//     type: The type of the block to be rendered.
-// Returns:
-//     A character representing such block.
-cursespp::Character board_character(tetris::BlockType type)
-{
-    return static_cast<cursespp::Character>(
-        " IOSZLJT="[static_cast<std::size_t>(type)]);
-}
+namespace {
 
-// "Draw" a tetris board.
-// Args:
-//     window: The window to draw to.
-//     board: The tetris board.
-//     row_offset: How many rows from the top-left corner to skip before
-//                 drawing.
-//     column_offset: How many columns from the top-left corner to skip before
-//                    drawing.
-void draw_board(
-    cursespp::Window& window,
-    tetris::Board const& board,
-    geom::Position offset = {0, 0})
+// Map a key to the game input it stands for, if any.
+std::optional<tetris::Input> key_input(int ch)
 {
-    for (auto r = 0; r < tetris::Board::rows; ++r) {
-        window.wmove(offset.row + r + 1, offset.column + 1);
-
-        for (auto c = 0; c < tetris::Board::columns; ++c) {
-            window.waddch(board_character(board[{r, c}]));
-            window.waddch(board_character(board[{r, c}]));
+    switch (ch) {
+        case KEY_UP: {
+            return tetris::Input::Rotate;
+        }
+        case KEY_DOWN: {
+            return tetris::Input::Down;
+        }
+        case KEY_LEFT: {
+            return tetris::Input::Left;
+        }
+        case KEY_RIGHT: {
+            return tetris::Input::Right;
+        }
+        case ' ': {
+            return tetris::Input::HardDrop;
+        }
+        default: {
+            return std::nullopt;
         }
     }
 }
 
-void draw_tetrimino(
-    cursespp::Window& window,
-    tetris::FallingTetrimino const& falling)
+// Show a game broadcast by another process until it ends or `q` is pressed.
+void watch(
+    char const* name,
+    cursespp::Curses& curses,
+    cursespp::Window& main_win,
+    cursespp::Window& board_window,
+    BoardRenderer& renderer)
 {
-    auto& tetrimino = falling.tetrimino.get();
-    auto type = tetrimino.type();
+    auto viewer = tetris::BroadcastViewer{name};
 
-    for (auto r = 0; r < 4; ++r) {
-        auto window_row = falling.position.row + r + 1;
-        auto first_column = 2 * (falling.position.column) + 1;
+    using namespace std::chrono_literals;
+    auto clock = gameloop::TickClock{16666us};
+    auto waiter = gameloop::InputWaiter{STDIN_FILENO};
 
-        for (auto c = 0; c < 4; ++c) {
-            auto window_column = first_column + 2 * c;
-            auto solid = tetrimino.shape()[{{r, c}, falling.rotation}];
+    while (not viewer.is_over()) {
+        viewer.poll();
 
-            if (solid) {
-                window.wmove(window_row, window_column);
-
-                window.waddch(board_character(type));
-                window.waddch(board_character(type));
+        for (auto ch = main_win.wgetch(); ch != ERR; ch = main_win.wgetch()) {
+            if (ch == 'q') {
+                return;
             }
         }
+
+        if (renderer.draw(board_window, viewer)) {
+            board_window.wnoutrefresh();
+            curses.doupdate();
+        }
+
+        // Nothing signals new frames, so look for them once per tick.
+        waiter.set_deadline(clock.deadline(clock.due_ticks()));
+        waiter.wait();
     }
 }
 
-int main()
+}
+
+// Keys: arrows move and rotate, space hard-drops where the rules allow it, `p`
+// pauses, `q` quits.
+//
+// Options:
+//     --ai: Let `tetris::Agent` play.
+//     --publish NAME: Broadcast the game under the shared memory NAME, such
+//                     as "/tetris".
+//     --watch NAME: Show the game broadcast under NAME instead of playing.
+//     --timings PATH: On exit, write per-stage frame timings to PATH.
+int main(int argc, char** argv)
 try {
+    char const* timings_path = nullptr;
+    char const* publish_name = nullptr;
+    char const* watch_name = nullptr;
+    auto ai = false;
+
+    for (auto i = 1; i < argc; ++i) {
+        auto option = std::string_view{argv[i]};
+
+        if (option == "--timings" and i + 1 < argc) {
+            timings_path = argv[++i];
+        } else if (option == "--publish" and i + 1 < argc) {
+            publish_name = argv[++i];
+        } else if (option == "--watch" and i + 1 < argc) {
+            watch_name = argv[++i];
+        } else if (option == "--ai") {
+            ai = true;
+        }
+    }
+
     auto& curses = cursespp::get_curses();
     auto& main_win = curses.get_stdscr();
 
@@ -87,8 +125,7 @@ try {
     main_win.wrefresh();
 
     auto rd = std::random_device{};
-    auto engine = std::default_random_engine{rd()};
-    auto game = tetris::Tetris{std::move(engine)};
+    auto game = tetris::Tetris{tetris::Rng{rd()}};
 
     auto board_window = curses.newwin(
         game.board().rows + 2,
@@ -97,56 +134,128 @@ try {
         0);
     board_window.add_box(0, 0);
 
-    while (not game.is_over()) {
-        using namespace std::chrono;
-        using namespace std::chrono_literals;
+    auto renderer = BoardRenderer{init_block_colors(curses)};
+
+    if (watch_name) {
+        watch(watch_name, curses, main_win, board_window, renderer);
+        return 0;
+    }
+
+    auto publisher = std::optional<tetris::BroadcastPublisher>{};
+
+    if (publish_name) {
+        publisher.emplace(publish_name);
+    }
+
+    auto pool = std::optional<util::ThreadPool>{};
+    auto agent = std::optional<tetris::Agent>{};
 
-        auto frame_start = high_resolution_clock::now();
+    if (ai) {
+        pool.emplace();
+        agent.emplace(tetris::AgentConfig{}, &*pool);
+    }
+
+    using namespace std::chrono_literals;
+    auto clock = gameloop::TickClock{16666us};
+    auto waiter = gameloop::InputWaiter{STDIN_FILENO};
+    auto timings = gameloop::FrameTimings{};
 
-        // Input
-        auto ch = main_win.wgetch();
+    // Ticks the game ran. A key press runs the next tick right away, so this
+    // may be ahead of the clock.
+    auto ticks_run = std::int64_t{0};
+    auto quit = false;
+
+    while (not quit and not game.is_over()) {
+        // Tick: catch up with the ticks that came due while waiting. Unless
+        // the agent plays, they have no input, so only the last one can
+        // change the game.
+        {
+            auto measurement = timings.measure(gameloop::Stage::Advance);
 
-        switch (ch) {
-            case 'q': {
-                return 0;
+            for (auto due = clock.due_ticks(); ticks_run < due; ++ticks_run) {
+                game.advance(
+                    agent ? agent->next_input(game) : tetris::Input::Nothing);
             }
         }
 
-        auto input = [&]()
-        {
-            switch (ch) {
-                case KEY_UP: {
-                    return tetris::Input::Rotate;
-                }
-                case KEY_DOWN: {
-                    return tetris::Input::Down;
-                }
-                case KEY_LEFT: {
-                    return tetris::Input::Left;
-                }
-                case KEY_RIGHT: {
-                    return tetris::Input::Right;
-                }
-                default: {
-                    return tetris::Input::Nothing;
+        // Input: drain every pending key.
+        while (not quit and not game.is_over()) {
+            auto ch = [&]()
+            {
+                auto measurement = timings.measure(gameloop::Stage::Input);
+                return main_win.wgetch();
+            }();
+
+            if (ch == ERR) {
+                break;
+            }
+
+            if (ch == 'q') {
+                quit = true;
+            } else if (ch == 'p') {
+                if (clock.paused()) {
+                    clock.resume();
+                } else {
+                    clock.pause();
                 }
+            } else if (auto input = key_input(ch);
+                       input and not clock.paused() and not agent) {
+                auto measurement = timings.measure(gameloop::Stage::Advance);
+                game.advance(*input);
+                ++ticks_run;
             }
-        }();
+        }
 
-        // Tick
-        game.advance(input);
+        if (publisher) {
+            publisher->publish(game);
+        }
 
         // Draw
-        draw_board(board_window, game.board());
-        draw_tetrimino(board_window, game.falling_tetrimino());
+        auto drawn = [&]()
+        {
+            auto measurement = timings.measure(gameloop::Stage::Draw);
 
-        board_window.wrefresh();
+            if (not renderer.draw(board_window, game)) {
+                return false;
+            }
+
+            board_window.wnoutrefresh();
+            return true;
+        }();
 
-        // Sleep for the remainder of the frame.
-        auto done = high_resolution_clock::now();
-        auto remaining_time = (frame_start + 16666us) - done;
-        std::this_thread::sleep_for(remaining_time);
+        if (drawn) {
+            auto measurement = timings.measure(gameloop::Stage::Refresh);
+            curses.doupdate();
+        }
+
+        // Sleep until a key is pressed or the game's next change is due. The
+        // agent may move on any tick.
+        auto ticks = game.ticks_until_update();
+
+        if (ticks and agent) {
+            ticks = 1;
+        }
+
+        if (ticks and not clock.paused()) {
+            waiter.set_deadline(clock.deadline(ticks_run + *ticks - 1));
+        } else {
+            waiter.clear_deadline();
+        }
+
+        waiter.wait();
+    }
+
+    // Let viewers see the game end.
+    if (publisher) {
+        publisher->publish(game);
     }
+
+    if (timings_path) {
+        auto out = std::ofstream{timings_path};
+        timings.write_report(out);
+    }
+
+    return 0;
 } catch (assertpp::AssertionError const& e) {
     if constexpr (assertpp::assertions_enabled) {
         std::clog << e.what() << '\n';
@@ -155,6 +264,12 @@ try {
 } catch (cursespp::CursesError const& e) {
     std::clog << e.what() << '\n';
     return 1;
+} catch (tetris::BroadcastError const& e) {
+    std::clog << e.what() << '\n';
+    return 1;
+} catch (std::system_error const& e) {
+    std::clog << e.what() << '\n';
+    return 1;
 } catch (...) {
     std::clog << "Aborted with unknown error.";
     return 1;
@@ -23,6 +23,47 @@ namespace cursespp {
 // Alias for curses' custom character type.
 using Character = chtype;
 
+// Alias for curses' attribute type.
+using Attributes = attr_t;
+
+// Non-owning view of a run of characters, like C++20's `std::span`.
+//
+// Implicitly built from any contiguous container with `data()` and `size()`,
+// so callers can pass their own buffers without copying them.
+class CharacterSpan {
+public:
+    CharacterSpan(Character const* data, int size): data_{data}, size_{size} {}
+
+    template <typename Container>
+    CharacterSpan(Container const& container):
+        data_{container.data()}, size_{static_cast<int>(container.size())}
+    {}
+
+    Character const* data() const
+    {
+        return data_;
+    }
+
+    int size() const
+    {
+        return size_;
+    }
+
+private:
+    Character const* data_;
+    int size_;
+};
+
+// Forward `COLOR_PAIR` (a macro).
+//
+// Returns:
+//     Attributes selecting a colour pair, to be OR-ed into characters or
+//     passed to `Window::wattr_on`.
+inline Attributes color_pair(short pair)
+{
+    return COLOR_PAIR(pair);
+}
+
 // Error on an ncurses function call.
 struct CursesError: std::runtime_error {
     using std::runtime_error::runtime_error;
@@ -36,7 +77,7 @@ namespace detail {
 //     result: The return of an curses function that returns ERR in
 //             case of error.
 //     message: What message to pass to the exception.
-void check_error(int result, const char* message)
+inline void check_error(int result, const char* message)
 {
     if (result == ERR) {
         throw CursesError{message};
@@ -89,6 +130,36 @@ public:
         detail::check_error(::waddch(window_, ch), "waddch call failed");
     }
 
+    // Write a run of characters, attributes included, at the cursor without
+    // advancing it or wrapping.
+    void waddchnstr(CharacterSpan chars)
+    {
+        detail::check_error(
+            ::waddchnstr(window_, chars.data(), chars.size()),
+            "waddchnstr call failed");
+    }
+
+    // Forward `mvwaddchnstr` (may be a macro).
+    void move_add_chars(int row, int column, CharacterSpan chars)
+    {
+        wmove(row, column);
+        waddchnstr(chars);
+    }
+
+    void wattr_on(Attributes attributes)
+    {
+        detail::check_error(
+            ::wattr_on(window_, attributes, nullptr),
+            "wattr_on call failed");
+    }
+
+    void wattr_off(Attributes attributes)
+    {
+        detail::check_error(
+            ::wattr_off(window_, attributes, nullptr),
+            "wattr_off call failed");
+    }
+
     int wgetch()
     {
         return ::wgetch(window_);
@@ -99,6 +170,15 @@ public:
         detail::check_error(::wrefresh(window_), "wrefresh call failed");
     }
 
+    // Copy the window to the virtual screen without updating the terminal.
+    // Follow with `Curses::doupdate` to send all windows' changes at once.
+    void wnoutrefresh()
+    {
+        detail::check_error(
+            ::wnoutrefresh(window_),
+            "wnoutrefresh call failed");
+    }
+
     void keypad(bool enable)
     {
         detail::check_error(::keypad(window_, enable), "keypad call failed");
@@ -168,6 +248,30 @@ public:
         detail::check_error(::curs_set(visibility), "curs_set call failed");
     }
 
+    // Update the terminal with every `Window::wnoutrefresh` since the last
+    // update, in a single write.
+    void doupdate()
+    {
+        detail::check_error(::doupdate(), "doupdate call failed");
+    }
+
+    bool has_colors()
+    {
+        return ::has_colors();
+    }
+
+    void start_color()
+    {
+        detail::check_error(::start_color(), "start_color call failed");
+    }
+
+    void init_pair(short pair, short foreground, short background)
+    {
+        detail::check_error(
+            ::init_pair(pair, foreground, background),
+            "init_pair call failed");
+    }
+
     // Get `stdscr` as a Window object.
     //
     // Notice that if you end up moving this you will break everything.
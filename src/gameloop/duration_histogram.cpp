@@ -0,0 +1,69 @@
+#include "duration_histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace gameloop {
+
+void DurationHistogram::record(Duration duration)
+{
+    auto value = static_cast<std::uint64_t>(
+        std::max(duration, Duration{0}).count());
+
+    ++counts_[bucket_of(value)];
+    ++count_;
+    max_ = std::max(max_, value);
+}
+
+DurationHistogram::Duration DurationHistogram::percentile(double fraction) const
+{
+    if (count_ == 0) {
+        return Duration{0};
+    }
+
+    auto rank = static_cast<std::uint64_t>(
+        std::ceil(fraction * static_cast<double>(count_)));
+    rank = std::clamp(rank, std::uint64_t{1}, count_);
+
+    auto seen = std::uint64_t{0};
+
+    for (auto bucket = std::size_t{0}; bucket < counts_.size(); ++bucket) {
+        seen += counts_[bucket];
+
+        if (seen >= rank) {
+            return Duration{std::min(bucket_top(bucket), max_)};
+        }
+    }
+
+    return Duration{max_};
+}
+
+// A value is split into a `shift` and the `2 * sub_buckets` wide `top` left
+// after shifting; for `shift > 0` the top's highest bit is always set, so only
+// `sub_buckets` distinct tops exist per shift.
+std::uint64_t DurationHistogram::bucket_of(std::uint64_t value)
+{
+    auto shift = 0u;
+
+    while ((value >> shift) >= 2 * sub_buckets) {
+        ++shift;
+    }
+
+    auto top = value >> shift;
+    return std::uint64_t{shift} * sub_buckets + top;
+}
+
+// Largest value that falls in a bucket.
+std::uint64_t DurationHistogram::bucket_top(std::uint64_t bucket)
+{
+    if (bucket < 2 * sub_buckets) {
+        return bucket;
+    }
+
+    auto shift = bucket / sub_buckets - 1;
+    auto top = bucket - shift * sub_buckets;
+
+    return ((top + 1) << shift) - 1;
+}
+
+}
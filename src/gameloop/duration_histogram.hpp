@@ -0,0 +1,62 @@
+#ifndef GAMELOOP_DURATION_HISTOGRAM_HPP
+#define GAMELOOP_DURATION_HISTOGRAM_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace gameloop {
+
+// Histogram of durations with a bounded relative error.
+//
+// Durations are bucketed by their highest set bit, with each power of two
+// split into `sub_buckets` linear buckets, so percentiles are reported within
+// `1 / sub_buckets` of the recorded value. The buckets cover every positive
+// `nanoseconds` value, and recording never allocates.
+class DurationHistogram {
+public:
+    using Duration = std::chrono::nanoseconds;
+
+    constexpr static auto sub_bucket_bits = 4;
+    constexpr static auto sub_buckets = 1 << sub_bucket_bits;
+
+    // Count a duration. Negative durations are counted as zero.
+    void record(Duration duration);
+
+    std::uint64_t count() const
+    {
+        return count_;
+    }
+
+    Duration max() const
+    {
+        return Duration{max_};
+    }
+
+    // Estimate a percentile.
+    //
+    // Args:
+    //     fraction: Which percentile, between 0 and 1 (e.g. 0.99 for p99).
+    //
+    // Returns:
+    //     A duration no smaller than `fraction` of the recorded ones, or
+    //     zero if nothing was recorded.
+    Duration percentile(double fraction) const;
+
+private:
+    // Values below `2 * sub_buckets` get one bucket each, every further power
+    // of two gets `sub_buckets`. Recorded values fit in 63 bits.
+    constexpr static auto bucket_count =
+        (63 - sub_bucket_bits + 1) * sub_buckets;
+
+    static std::uint64_t bucket_of(std::uint64_t value);
+    static std::uint64_t bucket_top(std::uint64_t bucket);
+
+    std::array<std::uint64_t, bucket_count> counts_{};
+    std::uint64_t count_ = 0;
+    std::uint64_t max_ = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,47 @@
+#include "fixed_step_loop.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace gameloop {
+
+FixedStepLoop::FixedStepLoop(
+    Clock::duration step,
+    CatchUp catch_up,
+    int max_catch_up):
+    step_{step},
+    catch_up_{catch_up},
+    max_catch_up_{std::max(max_catch_up, 1)},
+    next_deadline_{Clock::now()}
+{}
+
+int FixedStepLoop::wait_for_tick()
+{
+    auto now = Clock::now();
+
+    if (now < next_deadline_) {
+        std::this_thread::sleep_until(next_deadline_);
+        now = std::max(Clock::now(), next_deadline_);
+    }
+
+    // Every deadline up to `now` is due, the next one included.
+    auto due = 1 + (now - next_deadline_) / step_;
+    next_deadline_ += due * step_;
+    due_ticks_ += due;
+
+    auto ticks = catch_up_ == CatchUp::Replay
+                     ? std::min(due, std::int64_t{max_catch_up_})
+                     : std::int64_t{1};
+    dropped_ticks_ += due - ticks;
+
+    return static_cast<int>(ticks);
+}
+
+void FixedStepLoop::write_report(std::ostream& out) const
+{
+    out << "ticks: " << due_ticks_ << " due, " << dropped_ticks_
+        << " dropped\n";
+    timings_.write_report(out);
+}
+
+}
@@ -0,0 +1,86 @@
+#ifndef GAMELOOP_FIXED_STEP_LOOP_HPP
+#define GAMELOOP_FIXED_STEP_LOOP_HPP
+
+#include <chrono>
+#include <cstdint>
+
+#include "frame_timings.hpp"
+
+namespace gameloop {
+
+// What to do with ticks whose deadline passed while the loop was busy.
+enum class CatchUp {
+    // Run the missed ticks back to back, up to a limit, so the game keeps
+    // real time.
+    Replay,
+    // Drop the missed ticks and run a single one, so the game slows down
+    // instead of lurching forward.
+    Skip,
+};
+
+// Schedules ticks at a fixed rate.
+//
+// Deadlines are absolute: tick `n` is due at `start + n * step`, however
+// late the previous ones ran, so the tick rate does not drift with load or
+// oversleeping. Deadlines that are already past when the loop wakes up are
+// handled according to the `CatchUp` policy.
+class FixedStepLoop {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Args:
+    //     step: Time between ticks.
+    //     catch_up: How to handle missed ticks.
+    //     max_catch_up: Most ticks to run per frame with `CatchUp::Replay`.
+    //                   Missed ticks beyond it are dropped.
+    explicit FixedStepLoop(
+        Clock::duration step,
+        CatchUp catch_up = CatchUp::Replay,
+        int max_catch_up = 5);
+
+    // Sleep until the next tick is due.
+    //
+    // Returns:
+    //     How many ticks to run before the next call, at least one.
+    int wait_for_tick();
+
+    // Ticks whose deadline was reached so far, run or not.
+    std::int64_t due_ticks() const
+    {
+        return due_ticks_;
+    }
+
+    // Ticks dropped by the catch-up policy.
+    std::int64_t dropped_ticks() const
+    {
+        return dropped_ticks_;
+    }
+
+    FrameTimings& timings()
+    {
+        return timings_;
+    }
+
+    FrameTimings const& timings() const
+    {
+        return timings_;
+    }
+
+    // Write the tick counters followed by the stage timings.
+    void write_report(std::ostream& out) const;
+
+private:
+    Clock::duration step_;
+    CatchUp catch_up_;
+    int max_catch_up_;
+
+    Clock::time_point next_deadline_;
+    std::int64_t due_ticks_ = 0;
+    std::int64_t dropped_ticks_ = 0;
+
+    FrameTimings timings_;
+};
+
+}
+
+#endif
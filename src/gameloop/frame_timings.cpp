@@ -0,0 +1,62 @@
+#include "frame_timings.hpp"
+
+#include <iomanip>
+
+#include "unreachable.hpp"
+
+namespace gameloop {
+
+char const* stage_name(Stage stage)
+{
+    switch (stage) {
+        case Stage::Input: {
+            return "input";
+        }
+        case Stage::Advance: {
+            return "advance";
+        }
+        case Stage::Draw: {
+            return "draw";
+        }
+        case Stage::Refresh: {
+            return "refresh";
+        }
+    }
+
+    UTIL_MARK_UNREACHABLE;
+}
+
+void FrameTimings::write_report(std::ostream& out) const
+{
+    using Microseconds = std::chrono::duration<double, std::micro>;
+
+    auto write_us = [&](DurationHistogram::Duration duration)
+    {
+        out << std::setw(10) << Microseconds{duration}.count();
+    };
+
+    auto flags = out.flags();
+    out << std::fixed << std::setprecision(1);
+
+    out << std::left << std::setw(8) << "stage" << std::right
+        << std::setw(10) << "count" << std::setw(10) << "p50"
+        << std::setw(10) << "p99" << std::setw(10) << "p999"
+        << std::setw(10) << "max" << '\n';
+
+    for (auto i = 0; i < stage_count; ++i) {
+        auto stage = static_cast<Stage>(i);
+        auto const& histogram = this->histogram(stage);
+
+        out << std::left << std::setw(8) << stage_name(stage) << std::right
+            << std::setw(10) << histogram.count();
+        write_us(histogram.percentile(0.5));
+        write_us(histogram.percentile(0.99));
+        write_us(histogram.percentile(0.999));
+        write_us(histogram.max());
+        out << '\n';
+    }
+
+    out.flags(flags);
+}
+
+}
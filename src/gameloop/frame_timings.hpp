@@ -0,0 +1,83 @@
+#ifndef GAMELOOP_FRAME_TIMINGS_HPP
+#define GAMELOOP_FRAME_TIMINGS_HPP
+
+#include <array>
+#include <chrono>
+#include <ostream>
+
+#include "duration_histogram.hpp"
+
+namespace gameloop {
+
+// The parts of a frame that are timed separately.
+enum class Stage {
+    Input,
+    Advance,
+    Draw,
+    Refresh,
+};
+
+constexpr auto stage_count = 4;
+
+char const* stage_name(Stage stage);
+
+// Per-stage duration histograms of a game loop.
+class FrameTimings {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Times a stage from construction to destruction.
+    class Measurement {
+    public:
+        Measurement(FrameTimings& timings, Stage stage):
+            timings_{timings}, stage_{stage}, start_{Clock::now()}
+        {}
+
+        ~Measurement()
+        {
+            timings_.record(stage_, Clock::now() - start_);
+        }
+
+        Measurement(Measurement const&) = delete;
+        Measurement& operator=(Measurement const&) = delete;
+        Measurement(Measurement&&) = delete;
+        Measurement& operator=(Measurement&&) = delete;
+
+    private:
+        FrameTimings& timings_;
+        Stage stage_;
+        Clock::time_point start_;
+    };
+
+    // Start timing a stage, e.g.:
+    //
+    //     {
+    //         auto measurement = timings.measure(Stage::Draw);
+    //         draw();
+    //     }
+    Measurement measure(Stage stage)
+    {
+        return Measurement{*this, stage};
+    }
+
+    void record(Stage stage, DurationHistogram::Duration duration)
+    {
+        histograms_[static_cast<std::size_t>(stage)].record(duration);
+    }
+
+    DurationHistogram const& histogram(Stage stage) const
+    {
+        return histograms_[static_cast<std::size_t>(stage)];
+    }
+
+    // Write a table with the sample count, p50, p99, p999 and maximum of each
+    // stage, in microseconds.
+    void write_report(std::ostream& out) const;
+
+private:
+    std::array<DurationHistogram, stage_count> histograms_;
+};
+
+}
+
+#endif
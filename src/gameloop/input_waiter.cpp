@@ -0,0 +1,84 @@
+#include "input_waiter.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+
+#include <poll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "errno_error.hpp"
+
+namespace gameloop {
+
+InputWaiter::InputWaiter(int input_fd):
+    input_fd_{input_fd},
+    timer_fd_{::timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK)}
+{
+    if (timer_fd_ == -1) {
+        util::throw_errno("timerfd_create failed");
+    }
+}
+
+InputWaiter::~InputWaiter()
+{
+    ::close(timer_fd_);
+}
+
+// `steady_clock` is `CLOCK_MONOTONIC` on Linux, so its time points can be
+// handed to the timer as they are.
+void InputWaiter::set_deadline(Clock::time_point deadline)
+{
+    // A zero time would disarm the timer instead.
+    set_timer(std::max<std::chrono::nanoseconds>(
+        deadline.time_since_epoch(),
+        std::chrono::nanoseconds{1}));
+}
+
+void InputWaiter::clear_deadline()
+{
+    set_timer(std::chrono::nanoseconds{0});
+}
+
+InputWaiter::Event InputWaiter::wait()
+{
+    pollfd fds[] = {
+        {input_fd_, POLLIN, 0},
+        {timer_fd_, POLLIN, 0},
+    };
+
+    while (::poll(fds, 2, -1) == -1) {
+        if (errno != EINTR) {
+            util::throw_errno("poll failed");
+        }
+    }
+
+    if (fds[1].revents & POLLIN) {
+        auto expirations = std::uint64_t{};
+
+        if (::read(timer_fd_, &expirations, sizeof(expirations)) == -1 and
+            errno != EAGAIN) {
+            util::throw_errno("timerfd read failed");
+        }
+    }
+
+    return fds[0].revents ? Event::Input : Event::Deadline;
+}
+
+void InputWaiter::set_timer(std::chrono::nanoseconds since_epoch)
+{
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(
+        since_epoch);
+
+    auto spec = itimerspec{};
+    spec.it_value.tv_sec = seconds.count();
+    spec.it_value.tv_nsec = (since_epoch - seconds).count();
+
+    if (::timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr) ==
+        -1) {
+        util::throw_errno("timerfd_settime failed");
+    }
+}
+
+}
@@ -0,0 +1,60 @@
+#ifndef GAMELOOP_INPUT_WAITER_HPP
+#define GAMELOOP_INPUT_WAITER_HPP
+
+#include <chrono>
+
+namespace gameloop {
+
+// Sleeps until a file descriptor has input or a deadline passes.
+//
+// Built on a `timerfd` and `poll`, so a waiting process uses no CPU at all,
+// and input wakes it right away rather than at the next frame.
+class InputWaiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Event {
+        Input,
+        Deadline,
+    };
+
+    // Args:
+    //     input_fd: Descriptor to watch for input, e.g. `STDIN_FILENO`. It is
+    //               not owned.
+    //
+    // Throws:
+    //     std::system_error: If the timer can't be created.
+    explicit InputWaiter(int input_fd);
+
+    ~InputWaiter();
+
+    InputWaiter(InputWaiter const&) = delete;
+    InputWaiter& operator=(InputWaiter const&) = delete;
+    InputWaiter(InputWaiter&&) = delete;
+    InputWaiter& operator=(InputWaiter&&) = delete;
+
+    // Make `wait` return at `deadline`, replacing any previous deadline.
+    // Deadlines already past make `wait` return immediately.
+    void set_deadline(Clock::time_point deadline);
+
+    // Make `wait` return on input only.
+    void clear_deadline();
+
+    // Block until there is input or the deadline passed. A passed deadline
+    // only wakes a single `wait`.
+    //
+    // Returns:
+    //     What woke the waiter. Input wins if both are ready.
+    Event wait();
+
+private:
+    // Arm the timer for a `CLOCK_MONOTONIC` time, or disarm it with zero.
+    void set_timer(std::chrono::nanoseconds since_epoch);
+
+    int input_fd_;
+    int timer_fd_;
+};
+
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef GAMELOOP_TICK_CLOCK_HPP
+#define GAMELOOP_TICK_CLOCK_HPP
+
+#include <chrono>
+#include <cstdint>
+
+namespace gameloop {
+
+// Maps time to a fixed-rate tick count, for loops that sleep until something
+// happens instead of waking on every tick.
+//
+// Tick `n` is due at `start + n * step`, like the deadlines of
+// `FixedStepLoop`. Pausing stops the count; resuming shifts the start so the
+// count picks up where it stopped.
+class TickClock {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Start counting from tick zero, due now.
+    explicit TickClock(
+        Clock::duration step,
+        Clock::time_point now = Clock::now()):
+        step_{step}, start_{now}
+    {}
+
+    // Ticks whose deadline is at or before `now`, tick zero included.
+    std::int64_t due_ticks(Clock::time_point now = Clock::now()) const
+    {
+        if (paused_) {
+            return paused_ticks_;
+        }
+
+        return now < start_ ? 0 : 1 + (now - start_) / step_;
+    }
+
+    // When a tick is due.
+    Clock::time_point deadline(std::int64_t tick) const
+    {
+        return start_ + tick * step_;
+    }
+
+    bool paused() const
+    {
+        return paused_;
+    }
+
+    void pause(Clock::time_point now = Clock::now())
+    {
+        if (not paused_) {
+            paused_ticks_ = due_ticks(now);
+            paused_ = true;
+        }
+    }
+
+    // Resume counting, so that the tick after the last due one before the
+    // pause is due one step from now.
+    void resume(Clock::time_point now = Clock::now())
+    {
+        if (paused_) {
+            start_ = now - (paused_ticks_ - 1) * step_;
+            paused_ = false;
+        }
+    }
+
+private:
+    Clock::duration step_;
+    Clock::time_point start_;
+    bool paused_ = false;
+    std::int64_t paused_ticks_ = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,153 @@
+#include "ansi_renderer.hpp"
+
+#include <array>
+#include <charconv>
+
+namespace {
+
+using tetris::Board;
+using tetris::BlockType;
+
+// Background colour SGR parameter of each block type, by `BlockType` value.
+constexpr std::array<int, 9> block_colors = {
+    49,  // Empty: default background.
+    46,  // I: cyan.
+    43,  // O: yellow.
+    42,  // S: green.
+    41,  // Z: red.
+    47,  // L: white.
+    44,  // J: blue.
+    45,  // T: magenta.
+    107, // Line: bright white.
+};
+
+void append_int(std::string& out, int value)
+{
+    auto buffer = std::array<char, 12>{};
+    auto result =
+        std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+    out.append(buffer.data(), result.ptr);
+}
+
+// Move the cursor to a 1-based terminal position.
+void append_move(std::string& out, int row, int column)
+{
+    out += "\x1b[";
+    append_int(out, row);
+    out += ';';
+    append_int(out, column);
+    out += 'H';
+}
+
+void append_background(std::string& out, BlockType type)
+{
+    out += "\x1b[";
+    append_int(out, block_colors[static_cast<std::size_t>(type)]);
+    out += 'm';
+}
+
+}
+
+namespace server {
+
+bool AnsiRenderer::draw(tetris::Tetris& game, std::string& out)
+{
+    auto dirty = full_redraw_ ? Board::all_rows : game.dirty_rows();
+    auto show_game_over = game.is_over() and not game_over_shown_;
+
+    if (not dirty and not show_game_over) {
+        return false;
+    }
+
+    if (full_redraw_) {
+        draw_frame(out);
+    }
+
+    for (auto row = 0; row < Board::rows; ++row) {
+        if (dirty & (Board::RowSet{1} << row)) {
+            draw_row(game, row, out);
+        }
+    }
+
+    if (game.is_over()) {
+        append_move(out, Board::rows + 3, 1);
+        out += "GAME OVER - press q";
+        game_over_shown_ = true;
+    }
+
+    game.clear_dirty_rows();
+    full_redraw_ = false;
+    return true;
+}
+
+void AnsiRenderer::restore_terminal(std::string& out)
+{
+    // Reset attributes, show the cursor, clear and home.
+    out += "\x1b[0m\x1b[?25h\x1b[2J\x1b[H";
+}
+
+// Clear the screen, hide the cursor and draw the board's border, leaving the
+// inside to `draw_row`.
+void AnsiRenderer::draw_frame(std::string& out) const
+{
+    constexpr auto inner_width = 2 * Board::columns;
+
+    out += "\x1b[0m\x1b[?25l\x1b[2J\x1b[H+";
+    out.append(inner_width, '-');
+    out += '+';
+
+    for (auto row = 0; row < Board::rows; ++row) {
+        append_move(out, row + 2, 1);
+        out += '|';
+        append_move(out, row + 2, inner_width + 2);
+        out += '|';
+    }
+
+    append_move(out, Board::rows + 2, 1);
+    out += '+';
+    out.append(inner_width, '-');
+    out += '+';
+}
+
+void AnsiRenderer::draw_row(
+    tetris::Tetris const& game,
+    int row,
+    std::string& out) const
+{
+    auto types = std::array<BlockType, Board::columns>{};
+
+    for (auto c = 0; c < Board::columns; ++c) {
+        types[static_cast<std::size_t>(c)] = game.board()[{row, c}];
+    }
+
+    auto const& falling = game.falling_tetrimino();
+
+    for (auto const& block:
+         falling.tetrimino().layout(falling.rotation).blocks) {
+        auto position = falling.position + block;
+
+        if (position.row == row) {
+            types[static_cast<std::size_t>(position.column)] =
+                falling.tetrimino().type();
+        }
+    }
+
+    // Border is at column 1, the board starts right after it.
+    append_move(out, row + 2, 2);
+
+    auto previous = types[0];
+    append_background(out, previous);
+
+    for (auto type: types) {
+        if (type != previous) {
+            append_background(out, type);
+            previous = type;
+        }
+
+        out += "  ";
+    }
+
+    out += "\x1b[0m";
+}
+
+}
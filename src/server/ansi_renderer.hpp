@@ -0,0 +1,49 @@
+#ifndef SERVER_ANSI_RENDERER_HPP
+#define SERVER_ANSI_RENDERER_HPP
+
+#include <string>
+
+#include "tetris.hpp"
+
+namespace server {
+
+// Draws a game with plain ANSI escape sequences, for terminals that aren't
+// driven by curses.
+//
+// Frames are appended to a caller-owned string, so a session can reuse one
+// buffer and write each frame with a single call. Like the curses
+// `BoardRenderer`, only the game's dirty rows are redrawn, each block as two
+// coloured spaces.
+class AnsiRenderer {
+public:
+    // Append the escapes that bring the terminal up to date with a game.
+    //
+    // Args:
+    //     game: The game to draw. Its dirty rows are cleared.
+    //     out: Where to append the frame.
+    //
+    // Returns:
+    //     Whether anything was appended.
+    bool draw(tetris::Tetris& game, std::string& out);
+
+    // Make the next `draw` repaint the whole screen, e.g. after part of a
+    // frame was lost.
+    void invalidate()
+    {
+        full_redraw_ = true;
+    }
+
+    // Append the escapes that give the terminal back in its default state.
+    static void restore_terminal(std::string& out);
+
+private:
+    void draw_frame(std::string& out) const;
+    void draw_row(tetris::Tetris const& game, int row, std::string& out) const;
+
+    bool full_redraw_ = true;
+    bool game_over_shown_ = false;
+};
+
+}
+
+#endif
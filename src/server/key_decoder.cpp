@@ -0,0 +1,52 @@
+#include "key_decoder.hpp"
+
+#include "unreachable.hpp"
+
+namespace server {
+
+std::optional<Key> KeyDecoder::feed(char byte)
+{
+    switch (state_) {
+        case State::Ground: {
+            if (byte == '\x1b') {
+                state_ = State::Escape;
+            } else if (byte == 'q') {
+                return Key{Key::Kind::Quit};
+            } else if (byte == ' ') {
+                return Key{Key::Kind::Input, tetris::Input::HardDrop};
+            }
+
+            return std::nullopt;
+        }
+        case State::Escape: {
+            state_ = byte == '[' or byte == 'O' ? State::Sequence
+                                                : State::Ground;
+            return std::nullopt;
+        }
+        case State::Sequence: {
+            state_ = State::Ground;
+
+            switch (byte) {
+                case 'A': {
+                    return Key{Key::Kind::Input, tetris::Input::Rotate};
+                }
+                case 'B': {
+                    return Key{Key::Kind::Input, tetris::Input::Down};
+                }
+                case 'C': {
+                    return Key{Key::Kind::Input, tetris::Input::Right};
+                }
+                case 'D': {
+                    return Key{Key::Kind::Input, tetris::Input::Left};
+                }
+                default: {
+                    return std::nullopt;
+                }
+            }
+        }
+    }
+
+    UTIL_MARK_UNREACHABLE;
+}
+
+}
@@ -0,0 +1,47 @@
+#ifndef SERVER_KEY_DECODER_HPP
+#define SERVER_KEY_DECODER_HPP
+
+#include <optional>
+
+#include "tetris.hpp"
+
+namespace server {
+
+// What a key press asks a session to do.
+struct Key {
+    enum class Kind {
+        Input,
+        Quit,
+    };
+
+    Kind kind;
+    tetris::Input input = tetris::Input::Nothing;
+};
+
+// Turns the bytes a terminal sends into keys.
+//
+// Arrow keys arrive as `ESC [ A` to `ESC [ D` (or `ESC O A` to `ESC O D` in
+// application mode), possibly split across reads, so the decoder keeps the
+// escape sequence seen so far.
+class KeyDecoder {
+public:
+    // Feed one byte.
+    //
+    // Returns:
+    //     The key the byte completes, if any. Bytes that aren't part of a
+    //     known key are dropped.
+    std::optional<Key> feed(char byte);
+
+private:
+    enum class State {
+        Ground,
+        Escape,
+        Sequence,
+    };
+
+    State state_ = State::Ground;
+};
+
+}
+
+#endif
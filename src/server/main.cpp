@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "fixed_step_loop.hpp"
+#include "session.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+volatile std::sig_atomic_t stop_requested = 0;
+
+void request_stop(int)
+{
+    stop_requested = 1;
+}
+
+// Sessions stepped by each pool task; enough to amortize the task overhead.
+constexpr auto sessions_per_task = std::size_t{64};
+
+// Step every session once, spread over the pool.
+void step_all(std::vector<server::Session>& sessions, util::ThreadPool& pool)
+{
+    for (auto first = std::size_t{0}; first < sessions.size();
+         first += sessions_per_task) {
+        auto last = std::min(first + sessions_per_task, sessions.size());
+
+        pool.submit(
+            [&sessions, first, last]
+            {
+                for (auto i = first; i < last; ++i) {
+                    sessions[i].step();
+                }
+            });
+    }
+
+    pool.wait();
+}
+
+}
+
+// Hosts many games in one process, each on its own pseudo-terminal, and
+// prints the terminals' paths, one per line. Attach to a game with any
+// terminal program, e.g. `screen /dev/pts/N`. Runs until every player quit or
+// the server is interrupted.
+//
+// Options:
+//     --sessions N: How many games to host. Defaults to 4.
+//     --threads N: Worker threads stepping the games. Defaults to one per
+//                  hardware thread.
+//     --timings PATH: On exit, write tick timings to PATH.
+int main(int argc, char** argv)
+try {
+    auto session_count = 4ul;
+    auto thread_count = 0u;
+    char const* timings_path = nullptr;
+
+    for (auto i = 1; i + 1 < argc; i += 2) {
+        auto option = std::string_view{argv[i]};
+
+        if (option == "--sessions") {
+            session_count = std::strtoul(argv[i + 1], nullptr, 10);
+        } else if (option == "--threads") {
+            thread_count = static_cast<unsigned>(
+                std::strtoul(argv[i + 1], nullptr, 10));
+        } else if (option == "--timings") {
+            timings_path = argv[i + 1];
+        }
+    }
+
+    std::signal(SIGINT, request_stop);
+    std::signal(SIGTERM, request_stop);
+
+    auto rd = std::random_device{};
+    auto sessions = std::vector<server::Session>{};
+    sessions.reserve(session_count);
+
+    for (auto i = 0ul; i < session_count; ++i) {
+        sessions.emplace_back(tetris::Rng{rd()});
+        std::cout << sessions.back().terminal_path() << '\n';
+    }
+
+    std::cout.flush();
+
+    auto pool = util::ThreadPool{thread_count};
+
+    using namespace std::chrono_literals;
+    auto loop = gameloop::FixedStepLoop{16666us};
+
+    auto all_closed = [&]()
+    {
+        return std::all_of(
+            sessions.begin(),
+            sessions.end(),
+            [](auto const& session) { return session.closed(); });
+    };
+
+    while (not stop_requested and not all_closed()) {
+        auto ticks = loop.wait_for_tick();
+
+        for (auto tick = 0; tick < ticks; ++tick) {
+            auto measurement =
+                loop.timings().measure(gameloop::Stage::Advance);
+            step_all(sessions, pool);
+        }
+    }
+
+    if (timings_path) {
+        auto out = std::ofstream{timings_path};
+        loop.write_report(out);
+    }
+
+    return 0;
+} catch (std::system_error const& e) {
+    std::clog << e.what() << '\n';
+    return 1;
+}
@@ -0,0 +1,199 @@
+#include "session.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <system_error>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "errno_error.hpp"
+
+namespace {
+
+void check(int result, char const* what)
+{
+    if (result == -1) {
+        util::throw_errno(what);
+    }
+}
+
+}
+
+namespace server {
+
+Session::Session(tetris::Rng rng):
+    master_{::posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC)}, game_{rng}
+{
+    if (not master_) {
+        util::throw_errno("posix_openpt failed");
+    }
+
+    check(::grantpt(master_.get()), "grantpt failed");
+    check(::unlockpt(master_.get()), "unlockpt failed");
+
+    auto flags = ::fcntl(master_.get(), F_GETFL);
+    check(flags, "fcntl failed");
+    check(::fcntl(master_.get(), F_SETFL, flags | O_NONBLOCK), "fcntl failed");
+
+    char path[64];
+    auto error = ::ptsname_r(master_.get(), path, sizeof(path));
+
+    if (error != 0) {
+        throw std::system_error{error, std::generic_category(), "ptsname_r"};
+    }
+
+    terminal_path_ = path;
+    slave_ = util::FileDescriptor{
+        ::open(path, O_RDWR | O_NOCTTY | O_CLOEXEC)};
+
+    if (not slave_) {
+        util::throw_errno("opening the pseudo-terminal failed");
+    }
+
+    // Pass keys through as they are typed, without echo or line editing.
+    auto attributes = termios{};
+    check(::tcgetattr(slave_.get(), &attributes), "tcgetattr failed");
+    ::cfmakeraw(&attributes);
+    check(
+        ::tcsetattr(slave_.get(), TCSANOW, &attributes),
+        "tcsetattr failed");
+}
+
+void Session::step()
+{
+    if (closed_) {
+        return;
+    }
+
+    read_keys();
+
+    if (closed_) {
+        return;
+    }
+
+    game_.advance(inputs_.pop());
+
+    // Finish the frame the terminal didn't take before starting another, so
+    // the player never sees half an escape sequence.
+    if (stalled_ and not (writable() and write_output())) {
+        return;
+    }
+
+    if (renderer_.draw(game_, output_)) {
+        write_output();
+    }
+}
+
+void Session::read_keys()
+{
+    char buffer[256];
+
+    while (true) {
+        auto count = ::read(master_.get(), buffer, sizeof(buffer));
+
+        if (count <= 0) {
+            // EAGAIN: nothing typed. EIO: no player is attached. Anything
+            // else means the terminal is unusable.
+            if (count == -1 and errno != EAGAIN and errno != EIO) {
+                close();
+            }
+
+            return;
+        }
+
+        for (auto i = 0; i < count; ++i) {
+            auto key = decoder_.feed(buffer[i]);
+
+            if (not key) {
+                continue;
+            }
+
+            if (key->kind == Key::Kind::Quit) {
+                AnsiRenderer::restore_terminal(output_);
+                write_output();
+                close();
+                return;
+            }
+
+            if (not game_.is_over()) {
+                inputs_.push(key->input);
+            }
+        }
+    }
+}
+
+bool Session::write_output()
+{
+    while (sent_ < output_.size()) {
+        auto count = ::write(
+            master_.get(),
+            output_.data() + sent_,
+            output_.size() - sent_);
+
+        if (count >= 0) {
+            sent_ += static_cast<std::size_t>(count);
+            continue;
+        }
+
+        if (errno == EINTR) {
+            continue;
+        }
+
+        // The player isn't reading fast enough: keep the rest and skip
+        // frames until the terminal drains.
+        stalled_ = true;
+
+        if (errno != EAGAIN) {
+            // No player is attached: drop the frame, and repaint the whole
+            // screen for the next one.
+            renderer_.invalidate();
+            output_.clear();
+            sent_ = 0;
+        }
+
+        return false;
+    }
+
+    stalled_ = false;
+    output_.clear();
+    sent_ = 0;
+    return true;
+}
+
+bool Session::writable() const
+{
+    auto fd = pollfd{master_.get(), POLLOUT, 0};
+    return ::poll(&fd, 1, 0) == 1 and (fd.revents & POLLOUT);
+}
+
+void Session::close()
+{
+    closed_ = true;
+    slave_.reset();
+    master_.reset();
+}
+
+void Session::InputQueue::push(tetris::Input input)
+{
+    if (size_ < inputs_.size()) {
+        inputs_[(first_ + size_) % inputs_.size()] = input;
+        ++size_;
+    }
+}
+
+tetris::Input Session::InputQueue::pop()
+{
+    if (size_ == 0) {
+        return tetris::Input::Nothing;
+    }
+
+    auto input = inputs_[first_];
+    first_ = (first_ + 1) % inputs_.size();
+    --size_;
+    return input;
+}
+
+}
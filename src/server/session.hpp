@@ -0,0 +1,90 @@
+#ifndef SERVER_SESSION_HPP
+#define SERVER_SESSION_HPP
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+#include "ansi_renderer.hpp"
+#include "file_descriptor.hpp"
+#include "key_decoder.hpp"
+#include "tetris.hpp"
+
+namespace server {
+
+// A game played on its own pseudo-terminal.
+//
+// The session opens the terminal itself; a player attaches by opening
+// `terminal_path()` with any terminal program. All I/O is non-blocking, so a
+// session that nobody is attached to costs one failed read per tick.
+//
+// A session is only ever stepped by one thread at a time, but different
+// sessions may be stepped concurrently.
+class Session {
+public:
+    // Open a pseudo-terminal in raw mode and start a game on it.
+    //
+    // Throws:
+    //     std::system_error: If the terminal can't be opened.
+    explicit Session(tetris::Rng rng);
+
+    std::string const& terminal_path() const
+    {
+        return terminal_path_;
+    }
+
+    // Whether the player quit. Closed sessions ignore `step`.
+    bool closed() const
+    {
+        return closed_;
+    }
+
+    // Run one tick: read the keys that arrived, advance the game with the
+    // oldest one and send the player what changed.
+    void step();
+
+private:
+    // Keys read but not played yet. One is played per tick; keys arriving
+    // while it is full are dropped.
+    class InputQueue {
+    public:
+        void push(tetris::Input input);
+        tetris::Input pop();
+
+    private:
+        std::array<tetris::Input, 8> inputs_;
+        std::size_t first_ = 0;
+        std::size_t size_ = 0;
+    };
+
+    void read_keys();
+    // Send what is left of `output_`.
+    //
+    // Returns:
+    //     Whether all of it was sent.
+    bool write_output();
+    bool writable() const;
+    void close();
+
+    util::FileDescriptor master_;
+    // Held open so the terminal survives players attaching and leaving.
+    util::FileDescriptor slave_;
+    std::string terminal_path_;
+
+    tetris::Tetris game_;
+    KeyDecoder decoder_;
+    InputQueue inputs_;
+    AnsiRenderer renderer_;
+
+    // Frame being sent, reused between ticks.
+    std::string output_;
+    // How much of `output_` the terminal took so far.
+    std::size_t sent_ = 0;
+    // Whether the last frame didn't fit in the terminal's buffer.
+    bool stalled_ = false;
+    bool closed_ = false;
+};
+
+}
+
+#endif
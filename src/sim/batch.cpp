@@ -0,0 +1,79 @@
+#include "batch.hpp"
+
+#include <ostream>
+#include <utility>
+
+#include "rng.hpp"
+
+namespace sim {
+
+Policy input_sequence(std::vector<tetris::Input> inputs)
+{
+    return [inputs = std::move(inputs),
+            next = std::size_t{0}](tetris::Tetris const&) mutable
+    {
+        if (next == inputs.size()) {
+            return tetris::Input::Nothing;
+        }
+
+        return inputs[next++];
+    };
+}
+
+Policy random_inputs(std::uint32_t seed)
+{
+    // Inputs `Left` through `Nothing`.
+    constexpr auto inputs =
+        static_cast<std::uint32_t>(tetris::Input::Nothing) + 1;
+
+    return [engine = tetris::Pcg32{seed}](tetris::Tetris const&) mutable
+    {
+        return static_cast<tetris::Input>(
+            tetris::bounded_rand(engine, inputs));
+    };
+}
+
+std::ostream& operator<<(std::ostream& out, Report const& report)
+{
+    return out << report.games << " games, " << report.ticks << " ticks in "
+               << report.elapsed.count() << "s ("
+               << report.games_per_second() << " games/s, "
+               << report.ticks_per_second() << " ticks/s)";
+}
+
+BatchResult run_batch(std::vector<GameSpec> specs, util::ThreadPool& pool)
+{
+    using Clock = std::chrono::steady_clock;
+
+    auto results = std::vector<GameResult>(specs.size());
+    auto start = Clock::now();
+    auto tasks = util::TaskGroup{pool};
+
+    for (auto i = std::size_t{0}; i < specs.size(); ++i) {
+        tasks.submit(
+            [&spec = specs[i], &result = results[i]]
+            {
+                auto game =
+                    tetris::Tetris{tetris::Rng{spec.seed, spec.randomizer}};
+
+                while (not game.is_over() and result.ticks < spec.max_ticks) {
+                    game.advance(spec.policy(game));
+                    ++result.ticks;
+                }
+
+                result.over = game.is_over();
+            });
+    }
+
+    tasks.wait();
+
+    auto report = Report{specs.size(), 0, Clock::now() - start};
+
+    for (auto const& result: results) {
+        report.ticks += result.ticks;
+    }
+
+    return {std::move(results), report};
+}
+
+}
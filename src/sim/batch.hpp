@@ -0,0 +1,91 @@
+#ifndef SIM_BATCH_HPP
+#define SIM_BATCH_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <vector>
+
+#include "tetris.hpp"
+#include "thread_pool.hpp"
+
+// Headless simulation of many independent games: no rendering, no sleeping.
+
+namespace sim {
+
+// Chooses the input for a game's next tick.
+//
+// Each game gets its own copy, which is only ever called from one thread at a
+// time, so policies are free to keep state.
+using Policy = std::function<tetris::Input(tetris::Tetris const&)>;
+
+// Send a fixed sequence of inputs, then keep sending `Input::Nothing`.
+Policy input_sequence(std::vector<tetris::Input> inputs);
+
+// Send uniformly random inputs, `Input::Nothing` included.
+Policy random_inputs(std::uint32_t seed);
+
+// Everything needed to play one game.
+struct GameSpec {
+    tetris::Rng::Seed seed;
+    Policy policy;
+
+    // Stop the game after this many ticks even if it isn't over.
+    std::int64_t max_ticks;
+
+    tetris::Randomizer randomizer = tetris::Randomizer::Uniform;
+};
+
+struct GameResult {
+    std::int64_t ticks = 0;
+    bool over = false;
+};
+
+// Aggregate throughput of a batch.
+struct Report {
+    std::size_t games = 0;
+    std::int64_t ticks = 0;
+    std::chrono::duration<double> elapsed{0};
+
+    // Zero if no time elapsed, as for an empty batch.
+    double games_per_second() const
+    {
+        return elapsed.count() > 0
+                   ? static_cast<double>(games) / elapsed.count()
+                   : 0;
+    }
+
+    // Zero if no time elapsed, as for an empty batch.
+    double ticks_per_second() const
+    {
+        return elapsed.count() > 0
+                   ? static_cast<double>(ticks) / elapsed.count()
+                   : 0;
+    }
+};
+
+// Print a one-line summary of a report.
+std::ostream& operator<<(std::ostream& out, Report const& report);
+
+struct BatchResult {
+    // Results in the same order as the specs.
+    std::vector<GameResult> games;
+    Report report;
+};
+
+// Play every game on the pool, each as its own task.
+//
+// Args:
+//     specs: The games to play.
+//     pool: The pool to run the games on. Only the batch's own tasks are
+//           waited for, so the pool can be shared, even with the caller's
+//           task.
+//
+// Returns:
+//     Each game's result and the batch's throughput.
+BatchResult run_batch(std::vector<GameSpec> specs, util::ThreadPool& pool);
+
+}
+
+#endif
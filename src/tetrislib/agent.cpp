@@ -0,0 +1,288 @@
+#include "agent.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+namespace {
+
+constexpr auto lowest_score = std::numeric_limits<double>::lowest();
+
+// Zobrist keys of each search depth, XOR-ed with a board's hash so that a
+// board searched to different depths gets unrelated keys.
+constexpr std::uint64_t depth_keys[] = {
+    0xA5C5'6762'1A28'5F65,
+    0x5CA0'30F8'BF16'D380,
+    0xC99F'E8D0'0CA1'45E1,
+    0xD8F5'0136'EABC'11B4,
+    0x917C'491F'4F2E'4B29,
+};
+
+static_assert(std::size(depth_keys) > tetris::Agent::max_depth);
+
+// Lock a tetrimino into a board and remove the lines it completes.
+//
+// Returns:
+//     How many lines were removed.
+int lock_and_clear(tetris::Board& board, tetris::FallingTetrimino const& piece)
+{
+    board.lock(piece.tetrimino(), piece.position, piece.rotation);
+    auto full = board.full_rows();
+
+    if (not full) {
+        return 0;
+    }
+
+    board.collapse_rows(full);
+    return static_cast<int>(
+        std::bitset<tetris::Board::rows>{full}.count());
+}
+
+// Whether some tetrimino would end the game by not fitting where it spawns.
+bool tops_out(tetris::Board const& board)
+{
+    return std::any_of(
+        tetris::tetriminoes.begin(),
+        tetris::tetriminoes.end(),
+        [&](auto const& tetrimino)
+        {
+            auto spawn = tetris::FallingTetrimino{tetrimino};
+            return not board.piece_fits(
+                tetrimino,
+                spawn.position,
+                spawn.rotation);
+        });
+}
+
+// Blocks a tetrimino covers: its top row and its row masks, shifted so any
+// column it can be at gives a non-negative shift.
+std::pair<int, std::uint64_t> footprint(tetris::FallingTetrimino const& piece)
+{
+    auto const& layout = piece.tetrimino().layout(piece.rotation);
+
+    return {
+        piece.position.row + layout.min.row,
+        layout.row_masks << (piece.position.column + 4)};
+}
+
+}
+
+namespace tetris {
+
+TranspositionTable::TranspositionTable(std::size_t size)
+{
+    auto capacity = std::size_t{1};
+
+    while (capacity < size) {
+        capacity <<= 1;
+    }
+
+    entries_ = std::make_unique<Entry[]>(capacity);
+    mask_ = capacity - 1;
+}
+
+std::optional<double> TranspositionTable::find(std::uint64_t key) const
+{
+    key = full_key(key);
+
+    auto const& entry = entries_[key & mask_];
+    auto value = entry.value.load(std::memory_order_relaxed);
+    auto check = entry.check.load(std::memory_order_relaxed);
+
+    if ((check ^ value) != key) {
+        return std::nullopt;
+    }
+
+    auto score = 0.0;
+    std::memcpy(&score, &value, sizeof(score));
+    return score;
+}
+
+void TranspositionTable::store(std::uint64_t key, double score)
+{
+    key = full_key(key);
+
+    auto value = std::uint64_t{0};
+    std::memcpy(&value, &score, sizeof(value));
+
+    auto& entry = entries_[key & mask_];
+    entry.value.store(value, std::memory_order_relaxed);
+    entry.check.store(key ^ value, std::memory_order_relaxed);
+}
+
+// Generation zero is skipped, so that empty entries never match.
+std::uint64_t TranspositionTable::full_key(std::uint64_t key) const
+{
+    return key ^ ((generation_ + 1) * 0xD6E8'FEB8'6659'FD93);
+}
+
+Agent::Agent(AgentConfig config, util::ThreadPool* pool):
+    config_{config},
+    pool_{pool},
+    evaluator_{config.weights},
+    table_{config.table_size}
+{
+    config_.depth = std::clamp(config_.depth, 1, max_depth);
+}
+
+std::optional<FallingTetrimino> Agent::choose(Tetris const& game)
+{
+    if (game.is_over() or game.clearing()) {
+        return std::nullopt;
+    }
+
+    table_.new_generation();
+    candidates_ = finder_.find(game.board(), game.falling_tetrimino());
+    scores_.assign(candidates_.size(), lowest_score);
+
+    auto score_candidate = [this, &game](std::size_t i)
+    {
+        auto board = game.board();
+        auto lines = lock_and_clear(board, candidates_[i].piece);
+        scores_[i] = evaluate(board, lines, config_.depth - 1);
+    };
+
+    if (pool_) {
+        auto tasks = util::TaskGroup{*pool_};
+
+        for (auto i = std::size_t{0}; i < candidates_.size(); ++i) {
+            tasks.submit([&score_candidate, i] { score_candidate(i); });
+        }
+
+        tasks.wait();
+    } else {
+        for (auto i = std::size_t{0}; i < candidates_.size(); ++i) {
+            score_candidate(i);
+        }
+    }
+
+    auto best = std::max_element(scores_.begin(), scores_.end());
+
+    if (best == scores_.end()) {
+        return std::nullopt;
+    }
+
+    return candidates_[static_cast<std::size_t>(best - scores_.begin())]
+        .piece;
+}
+
+bool Agent::play(Tetris& game)
+{
+    auto landing = choose(game);
+    return landing and game.place(*landing);
+}
+
+Input Agent::next_input(Tetris const& game)
+{
+    if (game.is_over() or game.clearing()) {
+        return Input::Nothing;
+    }
+
+    auto find_target = [&]() -> Placement const*
+    {
+        if (not target_) {
+            return nullptr;
+        }
+
+        auto const& placements =
+            finder_.find(game.board(), game.falling_tetrimino());
+        auto wanted = footprint(*target_);
+        auto found = std::find_if(
+            placements.begin(),
+            placements.end(),
+            [&](auto const& placement)
+            { return footprint(placement.piece) == wanted; });
+
+        return found == placements.end() ? nullptr : &*found;
+    };
+
+    auto target = find_target();
+
+    if (not target) {
+        target_ = choose(game);
+        target = find_target();
+    }
+
+    if (not target) {
+        return Input::Nothing;
+    }
+
+    auto path = finder_.path_to(*target);
+    return path.empty() ? Input::Nothing : path.front();
+}
+
+// Score of a board right after a placement that cleared `lines` lines,
+// searching `depth` more tetriminoes.
+//
+// Only the lines of that placement and the ones searched count, so that a
+// board scores the same however it was reached, as the transposition table
+// needs.
+double Agent::evaluate(Board const& board, int lines, int depth)
+{
+    if (tops_out(board)) {
+        return lowest_score;
+    }
+
+    if (depth == 0) {
+        return evaluator_.score(compute_features(board), lines);
+    }
+
+    return config_.weights.lines_cleared * lines + expected(board, depth);
+}
+
+// Mean over every tetrimino of the best score reachable by placing it and
+// `depth - 1` more.
+double Agent::expected(Board const& board, int depth)
+{
+    auto key = board.hash() ^ depth_keys[static_cast<std::size_t>(depth)];
+
+    if (auto cached = table_.find(key)) {
+        return *cached;
+    }
+
+    auto mean = 0.0;
+
+    for (auto const& tetrimino: tetriminoes) {
+        auto best = search(board, FallingTetrimino{tetrimino}, depth);
+
+        // Losing with any tetrimino loses, rather than averaging it away.
+        if (best == lowest_score) {
+            mean = lowest_score;
+            break;
+        }
+
+        mean += best / static_cast<double>(tetriminoes.size());
+    }
+
+    table_.store(key, mean);
+    return mean;
+}
+
+// Best score reachable by placing a spawned tetrimino and `depth - 1` more.
+double Agent::search(
+    Board const& board,
+    FallingTetrimino const& falling,
+    int depth)
+{
+    // One finder per depth, since the placements of each level are iterated
+    // while the levels below search.
+    thread_local auto finders = std::array<PlacementFinder, max_depth>{};
+
+    auto const& placements =
+        finders[static_cast<std::size_t>(depth)].find(board, falling);
+    auto best = lowest_score;
+
+    for (auto const& placement: placements) {
+        auto child = board;
+        auto lines = lock_and_clear(child, placement.piece);
+        best = std::max(best, evaluate(child, lines, depth - 1));
+    }
+
+    return best;
+}
+
+}
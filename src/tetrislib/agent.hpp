@@ -0,0 +1,129 @@
+#ifndef TETRIS_AGENT_HPP
+#define TETRIS_AGENT_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "features.hpp"
+#include "placements.hpp"
+#include "tetris.hpp"
+#include "thread_pool.hpp"
+
+namespace tetris {
+
+// Caches search results by position, shared by every search thread.
+//
+// Entries are written and read without locks: each one stores its value and
+// its key XOR-ed with the value, so a torn entry just fails to match. Stale
+// entries are never cleared; a new search starts a new generation instead,
+// which is part of every key.
+class TranspositionTable {
+public:
+    // Args:
+    //     size: Number of entries, rounded up to a power of two.
+    explicit TranspositionTable(std::size_t size);
+
+    // Forget every entry, in constant time.
+    void new_generation()
+    {
+        ++generation_;
+    }
+
+    std::optional<double> find(std::uint64_t key) const;
+    void store(std::uint64_t key, double value);
+
+private:
+    struct Entry {
+        std::atomic<std::uint64_t> check{0};
+        std::atomic<std::uint64_t> value{0};
+    };
+
+    std::uint64_t full_key(std::uint64_t key) const;
+
+    std::unique_ptr<Entry[]> entries_;
+    std::size_t mask_;
+    std::uint64_t generation_ = 0;
+};
+
+struct AgentConfig {
+    // Tetriminoes to place in each search: the falling one, then the ones
+    // that may follow it. Up to `Agent::max_depth`.
+    int depth = 2;
+
+    FeatureWeights weights = el_tetris_weights;
+
+    // Entries in the transposition table.
+    std::size_t table_size = std::size_t{1} << 16;
+};
+
+// Plays by searching every sequence of placements of the next few
+// tetriminoes and scoring the boards they leave with a `LinearEvaluator`.
+//
+// Only the falling tetrimino is known: the game has no preview, and the agent
+// doesn't peek at its random number generator. Each tetrimino after it is
+// averaged over, taking the mean of the best scores of all 7 tetriminoes as if
+// they were equally likely. Boards some tetrimino can't spawn on score as
+// lost.
+class Agent {
+public:
+    constexpr static auto max_depth = 4;
+
+    // Args:
+    //     config: Search settings.
+    //     pool: Workers to spread each search over, one task per placement
+    //           of the falling tetrimino. Searches run on the calling thread
+    //           if null. `choose` only waits for its own tasks, so the pool
+    //           can be shared, even with tasks that run agents.
+    explicit Agent(AgentConfig config = {}, util::ThreadPool* pool = nullptr);
+
+    // Find the best place to lock the falling tetrimino.
+    //
+    // Returns:
+    //     The tetrimino where it should lock, or nothing if the game is over
+    //     or lines are being cleared.
+    std::optional<FallingTetrimino> choose(Tetris const& game);
+
+    // Lock the falling tetrimino at the best place in one call, for headless
+    // play.
+    //
+    // Returns:
+    //     Whether a tetrimino was placed.
+    bool play(Tetris& game);
+
+    // The input to steer the falling tetrimino towards the best place, one
+    // tick at a time, for real-time play.
+    //
+    // A place is chosen once per tetrimino. The path there is recomputed on
+    // every call, so gravity pulling the tetrimino off it is harmless.
+    Input next_input(Tetris const& game);
+
+private:
+    double evaluate(Board const& board, int lines, int depth);
+    double expected(Board const& board, int depth);
+    double search(
+        Board const& board,
+        FallingTetrimino const& falling,
+        int depth);
+
+    AgentConfig config_;
+    util::ThreadPool* pool_;
+    LinearEvaluator evaluator_;
+    TranspositionTable table_;
+    PlacementFinder finder_;
+
+    std::vector<Placement> candidates_;
+    std::vector<double> scores_;
+
+    // Where the tetrimino steered by `next_input` should lock. Once it does,
+    // the place is filled and no tetrimino can lock there any more, which
+    // triggers choosing a new one.
+    std::optional<FallingTetrimino> target_;
+};
+
+}
+
+#endif
@@ -0,0 +1,322 @@
+#include "batch_env.hpp"
+
+#include <bitset>
+
+#include "assert.hpp"
+
+namespace {
+
+using Rules = tetris::BatchEnv::Rules;
+
+constexpr auto board_rows = Rules::rows;
+constexpr auto board_columns = Rules::columns;
+constexpr auto full_cells = static_cast<tetris::BatchEnv::RowBits>(
+    (1u << board_columns) - 1u);
+
+// Bits below each board row in `fits`, so that a tetrimino sticking out to
+// the left of its shape's corner never needs a negative shift.
+constexpr auto margin = 3;
+
+tetris::PieceLayout const&
+layout_of(std::uint8_t tetrimino, std::uint8_t rotation)
+{
+    return tetris::tetriminoes[tetrimino].layout(
+        static_cast<geom::Rotation>(rotation));
+}
+
+}
+
+namespace tetris {
+
+BatchEnv::BatchEnv(
+    std::size_t size,
+    Rng::Seed seed,
+    Randomizer randomizer):
+    seed_{seed},
+    randomizer_{randomizer},
+    boards_(size * std::size_t{board_rows}, 0),
+    tetriminoes_(size),
+    rotations_(size),
+    rows_(size),
+    columns_(size),
+    ticks_(size),
+    clearing_ticks_(size),
+    lines_(size),
+    cleared_lines_(size),
+    episodes_(size, 0),
+    dones_(size, 0),
+    playing_(size),
+    due_(size)
+{
+    rngs_.reserve(size);
+
+    for (auto game = std::size_t{0}; game < size; ++game) {
+        rngs_.emplace_back(episode_seed(seed_, game, 0), randomizer_);
+        reset(game);
+    }
+}
+
+// Derive the seed of an episode of a game from the batch's seed, so that every
+// (game, episode) pair gets an unrelated stream.
+Rng::Seed BatchEnv::episode_seed(
+    Rng::Seed seed,
+    std::size_t game,
+    std::uint32_t episode)
+{
+    // splitmix64's finalizer.
+    auto x = std::uint64_t{seed} ^ (std::uint64_t{game} << 32) ^ episode;
+    x += 0x9E3779B97F4A7C15;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EB;
+    x ^= x >> 31;
+
+    return x;
+}
+
+// Each pass below does what `GameView::advance` does at that point of a
+// tick, for every game at once.
+void BatchEnv::step(std::vector<Input> const& inputs)
+{
+    assertpp::assert_predicate(
+        [&] { return inputs.size() == size(); },
+        "BatchEnv::step needs one input per game.");
+
+    auto const games = size();
+
+    // Games still clearing lines only count down.
+    for (auto game = std::size_t{0}; game < games; ++game) {
+        auto clearing = clearing_ticks_[game] > 0;
+        clearing_ticks_[game] -= clearing;
+        playing_[game] = not clearing;
+    }
+
+    for (auto game = std::size_t{0}; game < games; ++game) {
+        if (playing_[game] and cleared_lines_[game]) {
+            collapse(game);
+        }
+    }
+
+    for (auto game = std::size_t{0}; game < games; ++game) {
+        auto input = inputs[game];
+
+        if (playing_[game] and input != Input::Nothing and
+            input != Input::HardDrop) {
+            move(game, input);
+        }
+    }
+
+    // Games that don't fall this tick count the tick; the others restart
+    // counting once they fall or lock.
+    for (auto game = std::size_t{0}; game < games; ++game) {
+        auto due = playing_[game] and
+                   ticks_[game] >= Rules::ticks_to_fall(lines_[game]);
+        due_[game] = due;
+        ticks_[game] = due ? 0 : ticks_[game] + playing_[game];
+    }
+
+    for (auto game = std::size_t{0}; game < games; ++game) {
+        dones_[game] = 0;
+
+        if (due_[game]) {
+            fall_or_lock(game);
+        }
+    }
+
+    for (auto game = std::size_t{0}; game < games; ++game) {
+        if (dones_[game]) {
+            ++episodes_[game];
+            rngs_[game] = Rng{
+                episode_seed(seed_, game, episodes_[game]),
+                randomizer_};
+            reset(game);
+        }
+    }
+}
+
+void BatchEnv::observe(std::size_t game, Observation& observation) const
+{
+    auto const* board = &boards_[game * std::size_t{board_rows}];
+
+    for (auto row = std::size_t{0}; row < board_rows; ++row) {
+        observation.rows[row] = board[row];
+    }
+
+    observation.tetrimino = tetriminoes_[game];
+    observation.rotation = rotations_[game];
+    observation.row = rows_[game];
+    observation.column = columns_[game];
+    observation.ticks = ticks_[game];
+    observation.clearing_ticks = clearing_ticks_[game];
+    observation.lines = lines_[game];
+    observation.lock_ticks = 0;
+    observation.lock_resets = 0;
+    observation.held_ticks = 0;
+    observation.game_over = 0;
+}
+
+// Same as `Board::piece_fits`, over this layout's rows.
+bool BatchEnv::fits(
+    std::size_t game,
+    std::uint8_t tetrimino,
+    std::uint8_t rotation,
+    int row,
+    int column) const
+{
+    auto const& layout = layout_of(tetrimino, rotation);
+
+    if (row + layout.min.row < 0 or row + layout.max.row >= board_rows or
+        column + layout.min.column < 0 or
+        column + layout.max.column >= board_columns) {
+        return false;
+    }
+
+    auto const* board = &boards_[game * std::size_t{board_rows}];
+    auto top = row + layout.min.row;
+    auto window = std::uint64_t{0};
+
+    for (auto lane = 0; lane < 4 and top + lane < board_rows; ++lane) {
+        window |= std::uint64_t{board[top + lane]} << (16 * lane);
+    }
+
+    return ((window << margin) & (layout.row_masks << (column + margin))) == 0;
+}
+
+// Same as `try_move`.
+void BatchEnv::move(std::size_t game, Input input)
+{
+    auto tetrimino = tetriminoes_[game];
+    auto rotation = rotations_[game];
+    auto row = int{rows_[game]};
+    auto column = int{columns_[game]};
+
+    if (input == Input::Rotate) {
+        auto const& kicks = Rules::rotation_system::kicks(
+            tetrimino,
+            static_cast<geom::Rotation>(rotation));
+        auto new_rotation = static_cast<std::uint8_t>((rotation + 1) % 4);
+
+        for (auto i = 0; i < kicks.size; ++i) {
+            auto offset = kicks.offsets[static_cast<std::size_t>(i)];
+
+            if (fits(
+                    game,
+                    tetrimino,
+                    new_rotation,
+                    row + offset.row,
+                    column + offset.column)) {
+                rows_[game] = static_cast<std::int8_t>(row + offset.row);
+                columns_[game] =
+                    static_cast<std::int8_t>(column + offset.column);
+                rotations_[game] = new_rotation;
+                return;
+            }
+        }
+
+        return;
+    }
+
+    auto new_row = row + (input == Input::Down);
+    auto new_column =
+        column + (input == Input::Right) - (input == Input::Left);
+
+    if (fits(game, tetrimino, rotation, new_row, new_column)) {
+        rows_[game] = static_cast<std::int8_t>(new_row);
+        columns_[game] = static_cast<std::int8_t>(new_column);
+    }
+}
+
+// Same as the end of `GameView::game_tick`: fall a row, or lock, mark full
+// lines and spawn the next tetrimino.
+void BatchEnv::fall_or_lock(std::size_t game)
+{
+    auto tetrimino = tetriminoes_[game];
+    auto rotation = rotations_[game];
+    auto row = int{rows_[game]};
+    auto column = int{columns_[game]};
+
+    if (fits(game, tetrimino, rotation, row + 1, column)) {
+        rows_[game] = static_cast<std::int8_t>(row + 1);
+        return;
+    }
+
+    auto const& layout = layout_of(tetrimino, rotation);
+    auto* board = &boards_[game * std::size_t{board_rows}];
+    auto top = row + layout.min.row;
+    auto full = RowSet{0};
+
+    for (auto lane = 0; lane <= layout.max.row - layout.min.row; ++lane) {
+        auto shape_row = (layout.row_masks >> (16 * lane)) & 0xFFFF;
+        auto& cells = board[top + lane];
+        cells = static_cast<RowBits>(
+            cells | ((shape_row << (column + margin)) >> margin));
+
+        if (cells == full_cells) {
+            full |= RowSet{1} << (top + lane);
+        }
+    }
+
+    if (full) {
+        cleared_lines_[game] = full;
+        clearing_ticks_[game] = Rules::clear_delay;
+        lines_[game] += static_cast<std::int32_t>(
+            std::bitset<board_rows>{full}.count());
+    }
+
+    spawn(game);
+    dones_[game] = not fits(
+        game,
+        tetriminoes_[game],
+        rotations_[game],
+        rows_[game],
+        columns_[game]);
+}
+
+// Same as `Board::collapse_rows`.
+void BatchEnv::collapse(std::size_t game)
+{
+    auto* board = &boards_[game * std::size_t{board_rows}];
+    auto removed = cleared_lines_[game];
+    auto writing_row = board_rows - 1;
+
+    for (auto row = board_rows - 1; row >= 0; --row) {
+        if (not (removed & (RowSet{1} << row))) {
+            board[writing_row--] = board[row];
+        }
+    }
+
+    for (; writing_row >= 0; --writing_row) {
+        board[writing_row] = 0;
+    }
+
+    cleared_lines_[game] = 0;
+}
+
+void BatchEnv::spawn(std::size_t game)
+{
+    auto falling = FallingTetrimino{random_tetrimino(rngs_[game])};
+
+    tetriminoes_[game] = falling.index;
+    rotations_[game] = static_cast<std::uint8_t>(falling.rotation);
+    rows_[game] = static_cast<std::int8_t>(falling.position.row);
+    columns_[game] = static_cast<std::int8_t>(falling.position.column);
+}
+
+// Start a game over, on a fresh board, from `rngs_[game]`.
+void BatchEnv::reset(std::size_t game)
+{
+    auto* board = &boards_[game * std::size_t{board_rows}];
+
+    for (auto row = 0; row < board_rows; ++row) {
+        board[row] = 0;
+    }
+
+    auto state = GameState{FallingTetrimino{tetris::tetriminoes[0]}};
+
+    spawn(game);
+    ticks_[game] = state.ticks;
+    clearing_ticks_[game] = state.clearing_ticks;
+    lines_[game] = state.lines;
+    cleared_lines_[game] = state.cleared_lines;
+}
+
+}
@@ -0,0 +1,160 @@
+#ifndef TETRIS_BATCH_ENV_HPP
+#define TETRIS_BATCH_ENV_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "board.hpp"
+#include "observation.hpp"
+#include "rng.hpp"
+#include "rules.hpp"
+#include "tetris.hpp"
+
+namespace tetris {
+
+// A batch of games stepped together, for vectorized training environments.
+//
+// Games are stored as a structure of arrays: every field of the games has one
+// contiguous array, holding its value for each game in game order. A step
+// goes over the arrays one field at a time. The passes over counters are
+// plain loops the compiler vectorizes, and only the games whose tetrimino
+// moves, falls or locks take a per-game path, on those games' fields alone.
+//
+// The arrays are the observations: they are read in place, with no per-game
+// copy. Finished games restart in place with a fresh seed.
+//
+// Games follow `StandardRules` and play out exactly like a `Tetris` started
+// with `Rng{episode_seed(...), randomizer}` and given the same inputs.
+class BatchEnv {
+public:
+    using Rules = StandardRules;
+    using RowBits = Board::RowBits;
+    using RowSet = Board::RowSet;
+
+    // Start a batch of games.
+    //
+    // Args:
+    //     size: How many games to run.
+    //     seed: Base seed. Each game, and each restart of a game, derives its
+    //           own seed from it.
+    //     randomizer: How every game draws its tetriminoes.
+    BatchEnv(
+        std::size_t size,
+        Rng::Seed seed,
+        Randomizer randomizer = Randomizer::Uniform);
+
+    // The seed of an episode of a game, counting episodes from 0.
+    static Rng::Seed
+    episode_seed(Rng::Seed seed, std::size_t game, std::uint32_t episode);
+
+    std::size_t size() const
+    {
+        return tetriminoes_.size();
+    }
+
+    // Advance every game by one tick, restarting the ones that end.
+    //
+    // Args:
+    //     inputs: One input per game, in game order.
+    void step(std::vector<Input> const& inputs);
+
+    // Occupancy of every board: `Rules::rows` rows per game, in game order,
+    // each in the layout of `Observation::rows`.
+    std::vector<RowBits> const& boards() const
+    {
+        return boards_;
+    }
+
+    // The falling tetriminoes, as in `Observation`.
+    std::vector<std::uint8_t> const& tetriminoes() const
+    {
+        return tetriminoes_;
+    }
+
+    std::vector<std::uint8_t> const& rotations() const
+    {
+        return rotations_;
+    }
+
+    std::vector<std::int8_t> const& rows() const
+    {
+        return rows_;
+    }
+
+    std::vector<std::int8_t> const& columns() const
+    {
+        return columns_;
+    }
+
+    // `GameState` counters.
+    std::vector<std::int32_t> const& ticks() const
+    {
+        return ticks_;
+    }
+
+    std::vector<std::int32_t> const& clearing_ticks() const
+    {
+        return clearing_ticks_;
+    }
+
+    std::vector<std::int32_t> const& lines() const
+    {
+        return lines_;
+    }
+
+    // Whether each game ended (and was restarted) in the last step.
+    std::vector<std::uint8_t> const& dones() const
+    {
+        return dones_;
+    }
+
+    // Gather the fields of one game, such as to export it.
+    //
+    // Args:
+    //     game: The game's index.
+    //     observation: Where to write it.
+    void observe(std::size_t game, Observation& observation) const;
+
+private:
+    // The step only implements what these rules use.
+    static_assert(Rules::lock_delay == 0 and Rules::das == 0);
+    static_assert(not Rules::hard_drop and Rules::soft_drop_rows == 1);
+
+    bool fits(
+        std::size_t game,
+        std::uint8_t tetrimino,
+        std::uint8_t rotation,
+        int row,
+        int column) const;
+    void move(std::size_t game, Input input);
+    void fall_or_lock(std::size_t game);
+    void collapse(std::size_t game);
+    void spawn(std::size_t game);
+    void reset(std::size_t game);
+
+    Rng::Seed seed_;
+    Randomizer randomizer_;
+
+    std::vector<RowBits> boards_;
+    std::vector<std::uint8_t> tetriminoes_;
+    std::vector<std::uint8_t> rotations_;
+    std::vector<std::int8_t> rows_;
+    std::vector<std::int8_t> columns_;
+    std::vector<std::int32_t> ticks_;
+    std::vector<std::int32_t> clearing_ticks_;
+    std::vector<std::int32_t> lines_;
+    // Rows waiting to be removed once `clearing_ticks_` runs out.
+    std::vector<RowSet> cleared_lines_;
+    std::vector<Rng> rngs_;
+    std::vector<std::uint32_t> episodes_;
+    std::vector<std::uint8_t> dones_;
+
+    // Scratch space of `step`: whether each game plays the tick, rather than
+    // waiting for lines to clear, and whether gravity pulls it this tick.
+    std::vector<std::uint8_t> playing_;
+    std::vector<std::uint8_t> due_;
+};
+
+}
+
+#endif
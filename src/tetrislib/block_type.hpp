@@ -1,9 +1,12 @@
 #ifndef TETRIS_BLOCK_TYPE_HPP
 #define TETRIS_BLOCK_TYPE_HPP
 
+#include <cstdint>
+
 namespace tetris {
 
-enum class BlockType {
+// One byte per block, so that a board's colour plane stays compact.
+enum class BlockType : std::uint8_t {
     Empty,
     I,
     O,
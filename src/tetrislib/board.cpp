@@ -1 +1,182 @@
 #include "board.hpp"
+
+#include "assert.hpp"
+
+namespace {
+
+// Checking the bounds of every block written and recomputing the hash after
+// every change cost more than the changes themselves, so they are only done
+// on request, even when assertions are enabled.
+constexpr auto board_checks_enabled =
+#ifdef TETRISLIB_CHECK_BOARD
+    true
+#else
+    false
+#endif
+    ;
+
+}
+
+namespace tetris {
+
+template <typename Rules>
+void BasicBoard<Rules>::lock(
+    Tetrimino const& tetrimino,
+    Position top_left,
+    geom::Rotation rotation)
+{
+    for (auto const& block: tetrimino.layout(rotation).blocks) {
+        set(top_left + block, tetrimino.type());
+    }
+
+    check_hash();
+}
+
+template <typename Rules>
+typename BasicBoard<Rules>::RowSet BasicBoard<Rules>::full_rows() const
+{
+    auto full = RowSet{0};
+
+    if constexpr (bitboard_enabled) {
+        for (auto first_row = 0; first_row < rows; first_row += 4) {
+            auto lanes = full_lanes(window_at(first_row));
+
+            for (auto lane = 0; lane < 4; ++lane) {
+                auto row = first_row + lane;
+                auto lane_full = (lanes >> (16 * lane + 15)) & 1u;
+
+                if (row < rows and lane_full) {
+                    full |= RowSet{1} << row;
+                }
+            }
+        }
+    } else {
+        for (auto row = 0; row < rows; ++row) {
+            auto row_full = [&]()
+            {
+                for (auto c = 0; c < columns; ++c) {
+                    if (blocks_[{{row, c}}] == BlockType::Empty) {
+                        return false;
+                    }
+                }
+
+                return true;
+            }();
+
+            if (row_full) {
+                full |= RowSet{1} << row;
+            }
+        }
+    }
+
+    return full;
+}
+
+template <typename Rules>
+void BasicBoard<Rules>::fill_rows(RowSet rows_to_fill, BlockType type)
+{
+    for (auto row = 0; row < rows; ++row) {
+        if (rows_to_fill & (RowSet{1} << row)) {
+            for (auto c = 0; c < columns; ++c) {
+                set({row, c}, type);
+            }
+        }
+    }
+
+    check_hash();
+}
+
+template <typename Rules>
+void BasicBoard<Rules>::load_row(int row, RowBlocks const& blocks)
+{
+    for (auto c = 0; c < columns; ++c) {
+        set({row, c}, blocks[static_cast<std::size_t>(c)]);
+    }
+
+    check_hash();
+}
+
+template <typename Rules>
+void BasicBoard<Rules>::collapse_rows(RowSet rows_to_remove)
+{
+    auto writing_row = rows - 1;
+
+    for (auto row = writing_row; row >= 0; --row) {
+        if (rows_to_remove & (RowSet{1} << row)) {
+            continue;
+        }
+
+        if (row != writing_row) {
+            copy_row(row, writing_row);
+        }
+
+        --writing_row;
+    }
+
+    for (; writing_row >= 0; --writing_row) {
+        for (auto c = 0; c < columns; ++c) {
+            set({writing_row, c}, BlockType::Empty);
+        }
+    }
+
+    check_hash();
+}
+
+template <typename Rules>
+void BasicBoard<Rules>::set(Position pos, BlockType type)
+{
+    // Out of range columns would land in the neighbouring row.
+    if constexpr (board_checks_enabled) {
+        if (not in_bounds(pos)) {
+            throw assertpp::AssertionError{"Block written outside the board."};
+        }
+    }
+
+    blocks_[{pos}] = type;
+
+    auto bit = static_cast<RowBits>(1u << (pos.column + wall_width));
+    auto& row = occupancy_[static_cast<std::size_t>(pos.row)];
+    dirty_ |= RowSet{1} << pos.row;
+    hash_ ^= row_key(pos.row, row);
+
+    if (type == BlockType::Empty) {
+        row = static_cast<RowBits>(row & ~bit);
+    } else {
+        row = static_cast<RowBits>(row | bit);
+    }
+
+    hash_ ^= row_key(pos.row, row);
+}
+
+template <typename Rules>
+void BasicBoard<Rules>::copy_row(int from, int to)
+{
+    for (auto c = 0; c < columns; ++c) {
+        blocks_[{{to, c}}] = blocks_[{{from, c}}];
+    }
+
+    auto& row = occupancy_[static_cast<std::size_t>(to)];
+    hash_ ^= row_key(to, row);
+    row = occupancy_[static_cast<std::size_t>(from)];
+    hash_ ^= row_key(to, row);
+    dirty_ |= RowSet{1} << to;
+}
+
+template <typename Rules>
+void BasicBoard<Rules>::check_hash() const
+{
+    if constexpr (board_checks_enabled) {
+        if (hash_ != compute_hash()) {
+            throw assertpp::AssertionError{
+                "Incremental board hash differs from a recomputed one."};
+        }
+    }
+}
+
+template class BasicBoard<StandardRules>;
+template class BasicBoard<TallRules>;
+template class BasicBoard<CompactRules>;
+template class BasicBoard<ModernRules>;
+template class BasicBoard<Rows32Rules>;
+
+}
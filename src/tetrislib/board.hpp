@@ -1,22 +1,69 @@
 #ifndef TETRIS_BOARD_HPP
 #define TETRIS_BOARD_HPP
 
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
 #include "block_type.hpp"
 #include "matrix.hpp"
+#include "rules.hpp"
 #include "tetriminoes.hpp"
 
 namespace tetris {
-class Board {
+
+// Select the bitboard kernels for collision tests and line clears. When
+// disabled, the same queries are answered by scanning the colour plane.
+constexpr auto bitboard_enabled =
+#ifdef TETRISLIB_BITBOARD
+    true
+#else
+    false
+#endif
+    ;
+
+// A board sized by a rules type (see `rules.hpp`).
+template <typename Rules> class BasicBoard {
 public:
-    constexpr static auto rows = 20;
-    constexpr static auto columns = 10;
+    constexpr static auto rows = Rules::rows;
+    constexpr static auto columns = Rules::columns;
 
     using Blocks = geom::Matrix2D<BlockType, rows, columns>;
     using Position = geom::Position;
 
-    Board(): blocks_{}
+    // Blocks of a single row, left to right.
+    using RowBlocks = std::array<BlockType, columns>;
+
+    // Occupancy of a single row. Column `c` is bit `wall_width + c`; the bits
+    // outside the playfield are always set, acting as walls.
+    using RowBits = std::uint16_t;
+
+    // A set of rows, where row `r` is bit `r`.
+    using RowSet =
+        std::conditional_t<(rows < 32), std::uint32_t, std::uint64_t>;
+
+    constexpr static RowSet all_rows = (RowSet{1} << rows) - 1;
+
+    constexpr static auto wall_width = 3;
+    constexpr static RowBits full_row = 0xFFFF;
+    constexpr static RowBits empty_row = static_cast<RowBits>(
+        full_row & ~(((1u << columns) - 1u) << wall_width));
+
+    static_assert(rows > 0 and rows < 64, "Rows must fit in a RowSet.");
+    static_assert(
+        columns > 0 and columns + 2 * wall_width <= 16,
+        "Columns and walls must fit in RowBits.");
+
+    BasicBoard(): blocks_{}
     {
         blocks_.fill(BlockType::Empty);
+        occupancy_.fill(full_row);
+
+        for (auto row = 0; row < rows; ++row) {
+            occupancy_[static_cast<std::size_t>(row)] = empty_row;
+        }
+
+        hash_ = compute_hash();
     }
 
     BlockType operator[](Position pos) const
@@ -25,15 +72,44 @@ public:
         return blocks_[{{pos.row, pos.column}}];
     }
 
-    BlockType& operator[](Position pos)
+    const Blocks& blocks() const
     {
+        return blocks_;
+    }
 
-        return blocks_[{{pos.row, pos.column}}];
+    // Zobrist-style hash of which blocks are filled, whatever their colour.
+    //
+    // Each row contributes a pseudo-random key of its index and occupancy,
+    // and the keys are XOR-ed together. Every change to the board updates
+    // the keys of the rows it touches, so reading the hash is free and moving
+    // rows in a line clear costs one key per row.
+    std::uint64_t hash() const
+    {
+        return hash_;
     }
 
-    const Blocks& blocks() const
+    // Recompute `hash()` from scratch.
+    std::uint64_t compute_hash() const
     {
-        return blocks_;
+        auto hash = std::uint64_t{0};
+
+        for (auto row = 0; row < rows; ++row) {
+            hash ^= row_key(row, row_bits(row));
+        }
+
+        return hash;
+    }
+
+    // Occupancy bits of a row, in the layout described by `RowBits`.
+    RowBits row_bits(int row) const
+    {
+        return occupancy_[static_cast<std::size_t>(row)];
+    }
+
+    // Occupancy of a row without the walls: bit `c` stands for column `c`.
+    RowBits row_cells(int row) const
+    {
+        return static_cast<RowBits>((row_bits(row) & ~empty_row) >> wall_width);
     }
 
     bool in_bounds(Position pos) const
@@ -47,29 +123,160 @@ public:
         Position top_left,
         geom::Rotation rotation) const
     {
-        for (auto row = 0; row < 4; ++row) {
-            for (auto column = 0; column < 4; ++column) {
-                auto board_position = top_left + Position{row, column};
+        if constexpr (bitboard_enabled) {
+            return piece_fits_bits(tetrimino, top_left, rotation);
+        } else {
+            return piece_fits_blocks(tetrimino, top_left, rotation);
+        }
+    }
+
+    // Write a tetrimino's blocks into the board.
+    //
+    // Args:
+    //     tetrimino: The tetrimino to write.
+    //     top_left: Board position of the tetrimino's shape top-left corner.
+    //     rotation: The tetrimino's rotation.
+    void lock(
+        Tetrimino const& tetrimino,
+        Position top_left,
+        geom::Rotation rotation);
+
+    // Find the rows that have no empty block.
+    RowSet full_rows() const;
+
+    // Overwrite every block in a set of rows.
+    void fill_rows(RowSet rows_to_fill, BlockType type);
+
+    // Overwrite the blocks of a row, such as with a copy of another board's.
+    void load_row(int row, RowBlocks const& blocks);
+
+    // Rows whose blocks changed since the last `clear_dirty_rows`. A new
+    // board starts with every row dirty.
+    RowSet dirty_rows() const
+    {
+        return dirty_;
+    }
+
+    void clear_dirty_rows()
+    {
+        dirty_ = 0;
+    }
+
+    // Remove a set of rows, moving the rows above them down and emptying the
+    // rows left at the top.
+    void collapse_rows(RowSet rows_to_remove);
+
+private:
+    // Four consecutive rows, one in each 16-bit lane.
+    using RowWindow = std::uint64_t;
+
+    constexpr static RowWindow lane_low_bits = 0x7FFF'7FFF'7FFF'7FFF;
+
+    // Load the four rows starting at `row`, the first one in the lowest lane.
+    RowWindow window_at(int row) const
+    {
+        auto first = static_cast<std::size_t>(row);
+
+        return RowWindow{occupancy_[first]} |
+               RowWindow{occupancy_[first + 1]} << 16 |
+               RowWindow{occupancy_[first + 2]} << 32 |
+               RowWindow{occupancy_[first + 3]} << 48;
+    }
+
+    // Lanes of `window` that are all ones have their top bit set in the
+    // result, all other bits are clear.
+    constexpr static RowWindow full_lanes(RowWindow window)
+    {
+        auto inverted = ~window;
+        return ~(((inverted & lane_low_bits) + lane_low_bits) | inverted |
+                 lane_low_bits);
+    }
+
+    // Key of a row with some occupancy: splitmix64's finalizer over both.
+    constexpr static std::uint64_t row_key(int row, RowBits bits)
+    {
+        auto key = std::uint64_t{bits} << 6 | static_cast<std::uint64_t>(row);
+        key *= 0x9E37'79B9'7F4A'7C15;
+        key = (key ^ (key >> 30)) * 0xBF58'476D'1CE4'E5B9;
+        key = (key ^ (key >> 27)) * 0x94D0'49BB'1331'11EB;
+        return key ^ (key >> 31);
+    }
+
+    // Whether a layout's bounding box lies within the board.
+    static bool layout_in_bounds(PieceLayout const& layout, Position top_left)
+    {
+        return top_left.row + layout.min.row >= 0 and
+               top_left.row + layout.max.row < rows and
+               top_left.column + layout.min.column >= 0 and
+               top_left.column + layout.max.column < columns;
+    }
+
+    bool piece_fits_bits(
+        Tetrimino const& tetrimino,
+        Position top_left,
+        geom::Rotation rotation) const
+    {
+        auto const& layout = tetrimino.layout(rotation);
+
+        if (not layout_in_bounds(layout, top_left)) {
+            return false;
+        }
 
-                auto solid = tetrimino.shape()[{{row, column}, rotation}];
+        auto piece = layout.row_masks << (top_left.column + wall_width);
 
-                if (solid) {
-                    auto position_empty =
-                        blocks_[{board_position}] == BlockType::Empty;
+        return (window_at(top_left.row + layout.min.row) & piece) == 0;
+    }
 
-                    if (not in_bounds(board_position) or not position_empty) {
-                        return false;
-                    }
-                }
+    bool piece_fits_blocks(
+        Tetrimino const& tetrimino,
+        Position top_left,
+        geom::Rotation rotation) const
+    {
+        auto const& layout = tetrimino.layout(rotation);
+
+        if (not layout_in_bounds(layout, top_left)) {
+            return false;
+        }
+
+        for (auto const& block: layout.blocks) {
+            if (blocks_[{top_left + block}] != BlockType::Empty) {
+                return false;
             }
         }
 
         return true;
     }
 
-private:
+    // Write a single block, keeping the occupancy bits in sync. The block
+    // is only checked to be on the board if `TETRISLIB_CHECK_BOARD` is
+    // defined.
+    void set(Position pos, BlockType type);
+
+    // Copy a whole row over another one.
+    void copy_row(int from, int to);
+
+    // Check `hash_` against `compute_hash()`, if `TETRISLIB_CHECK_BOARD` is
+    // defined.
+    void check_hash() const;
+
     Blocks blocks_;
+
+    // Occupancy of each row, followed by four solid rows acting as the floor
+    // so that a window can always be loaded from any row on the board.
+    std::array<RowBits, rows + 4> occupancy_;
+
+    RowSet dirty_ = all_rows;
+    std::uint64_t hash_ = 0;
 };
+
+extern template class BasicBoard<StandardRules>;
+extern template class BasicBoard<TallRules>;
+extern template class BasicBoard<CompactRules>;
+extern template class BasicBoard<ModernRules>;
+extern template class BasicBoard<Rows32Rules>;
+
+using Board = BasicBoard<StandardRules>;
+
 }
 
 #endif
@@ -0,0 +1,269 @@
+#include "broadcast.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include "bits.hpp"
+
+namespace {
+
+constexpr auto broadcast_magic = std::uint32_t{0x5442'5354};
+constexpr auto broadcast_version = std::uint32_t{1};
+
+struct Header {
+    // Set last, once the rest of the ring is ready.
+    std::atomic<std::uint32_t> magic;
+
+    // What the ring was laid out for, to reject other builds.
+    std::uint32_t version;
+    std::uint32_t rows;
+    std::uint32_t columns;
+    std::uint32_t capacity;
+    std::uint32_t slot_size;
+
+    // Number of the last frame published, or 0 before the first one. Kept on
+    // its own cache line, since it changes every frame.
+    alignas(64) std::atomic<std::uint64_t> published;
+    // Number of the latest keyframe, or 0 before the first one.
+    std::atomic<std::uint64_t> keyframe;
+};
+
+struct alignas(64) Slot {
+    // Number of the frame held, or 0 while a frame is being written.
+    std::atomic<std::uint64_t> number;
+    tetris::BroadcastFrame frame;
+};
+
+static_assert(
+    std::atomic<std::uint64_t>::is_always_lock_free and
+        std::atomic<std::uint32_t>::is_always_lock_free,
+    "Atomics in shared memory must not rely on process-local locks.");
+
+constexpr auto ring_size =
+    sizeof(Header) + tetris::broadcast_capacity * sizeof(Slot);
+
+// Bytes of a frame up to and including its first `rows` rows.
+std::size_t frame_size(std::size_t rows)
+{
+    return offsetof(tetris::BroadcastFrame, rows) +
+           rows * sizeof(tetris::Board::RowBlocks);
+}
+
+Header const& header(util::SharedMemory const& memory)
+{
+    return *static_cast<Header const*>(memory.data());
+}
+
+Slot const& slot(util::SharedMemory const& memory, std::uint64_t number)
+{
+    auto slots = reinterpret_cast<Slot const*>(
+        static_cast<unsigned char const*>(memory.data()) + sizeof(Header));
+
+    return slots[number % tetris::broadcast_capacity];
+}
+
+Slot& slot(util::SharedMemory& memory, std::uint64_t number)
+{
+    return const_cast<Slot&>(slot(std::as_const(memory), number));
+}
+
+}
+
+namespace tetris {
+
+BroadcastPublisher::BroadcastPublisher(std::string name):
+    memory_{std::move(name), ring_size}, falling_{tetriminoes[0]}
+{
+    auto& ring_header = *new (memory_.data()) Header{};
+    ring_header.version = broadcast_version;
+    ring_header.rows = Board::rows;
+    ring_header.columns = Board::columns;
+    ring_header.capacity = broadcast_capacity;
+    ring_header.slot_size = sizeof(Slot);
+
+    for (auto number = 0; number < broadcast_capacity; ++number) {
+        new (&slot(memory_, static_cast<std::uint64_t>(number))) Slot{};
+    }
+
+    ring_header.magic.store(broadcast_magic, std::memory_order_release);
+}
+
+void BroadcastPublisher::publish(Tetris const& game)
+{
+    auto const& board = game.board();
+    auto keyframe = (next_ - 1) % keyframe_interval == 0;
+    auto changed = std::size_t{0};
+    frame_.changed_rows = 0;
+
+    // Other rows are still as they were sent. Going from the lowest bit up
+    // keeps the rows in top to bottom order.
+    auto candidates = keyframe ? Board::all_rows : game.dirty_rows();
+
+    for (; candidates; candidates &= candidates - 1) {
+        auto r = util::countr_zero(candidates);
+        auto row = Board::RowBlocks{};
+
+        for (auto c = 0; c < Board::columns; ++c) {
+            row[static_cast<std::size_t>(c)] = board[{r, c}];
+        }
+
+        auto& sent = rows_[static_cast<std::size_t>(r)];
+
+        if (keyframe or row != sent) {
+            sent = row;
+            frame_.rows[changed++] = row;
+            frame_.changed_rows |= Board::RowSet{1} << r;
+        }
+    }
+
+    auto const& falling = game.falling_tetrimino();
+    auto moved = falling.index != falling_.index or
+                 falling.rotation != falling_.rotation or
+                 falling.position.row != falling_.position.row or
+                 falling.position.column != falling_.position.column;
+
+    if (not keyframe and not changed and not moved and
+        game.lines() == lines_ and game.is_over() == game_over_) {
+        return;
+    }
+
+    falling_ = falling;
+    lines_ = game.lines();
+    game_over_ = game.is_over();
+
+    frame_.tetrimino = falling.index;
+    frame_.rotation = static_cast<std::uint8_t>(falling.rotation);
+    frame_.row = static_cast<std::int8_t>(falling.position.row);
+    frame_.column = static_cast<std::int8_t>(falling.position.column);
+    frame_.game_over = game_over_;
+    frame_.lines = lines_;
+
+    auto number = next_++;
+    auto& target = slot(memory_, number);
+
+    target.number.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&target.frame, &frame_, frame_size(changed));
+    target.number.store(number, std::memory_order_release);
+
+    auto& ring_header = *static_cast<Header*>(memory_.data());
+
+    if (keyframe) {
+        ring_header.keyframe.store(number, std::memory_order_release);
+    }
+
+    ring_header.published.store(number, std::memory_order_release);
+}
+
+BroadcastViewer::BroadcastViewer(std::string name):
+    memory_{std::move(name)}, falling_{tetriminoes[0]}, shown_{falling_}
+{
+    if (memory_.size() < sizeof(Header) or
+        header(memory_).magic.load(std::memory_order_acquire) !=
+            broadcast_magic) {
+        throw BroadcastError{"Not a broadcast."};
+    }
+
+    auto const& ring_header = header(memory_);
+
+    if (ring_header.version != broadcast_version or
+        ring_header.rows != Board::rows or
+        ring_header.columns != Board::columns or
+        ring_header.capacity != broadcast_capacity or
+        ring_header.slot_size != sizeof(Slot) or memory_.size() < ring_size) {
+        throw BroadcastError{"Broadcast was published by another build."};
+    }
+}
+
+bool BroadcastViewer::poll()
+{
+    auto const& ring_header = header(memory_);
+    auto published = ring_header.published.load(std::memory_order_acquire);
+    auto applied = false;
+    // Whether this call started over from a keyframe already. Only one
+    // restart is tried, so a publisher lapping the viewer can't stall it.
+    auto restarted = next_ == 0;
+
+    if (next_ == 0) {
+        next_ = ring_header.keyframe.load(std::memory_order_acquire);
+    }
+
+    // The frame at `next_` was overwritten: start over, if possible.
+    auto restart = [&]()
+    {
+        next_ = restarted ? 0
+                          : ring_header.keyframe.load(std::memory_order_acquire);
+        restarted = true;
+    };
+
+    while (next_ != 0 and next_ <= published) {
+        auto const& source = slot(memory_, next_);
+
+        if (source.number.load(std::memory_order_acquire) != next_) {
+            restart();
+            continue;
+        }
+
+        // The row count is only trusted once the copy is known to be whole,
+        // so bound it by the frame's size meanwhile.
+        std::memcpy(&frame_, &source.frame, frame_size(0));
+        auto rows = std::min(
+            util::popcount(frame_.changed_rows),
+            static_cast<int>(Board::rows));
+        std::memcpy(
+            frame_.rows.data(),
+            source.frame.rows.data(),
+            static_cast<std::size_t>(rows) * sizeof(Board::RowBlocks));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (source.number.load(std::memory_order_relaxed) != next_) {
+            restart();
+            continue;
+        }
+
+        apply(frame_);
+        applied = true;
+        ++next_;
+    }
+
+    return applied;
+}
+
+void BroadcastViewer::apply(BroadcastFrame const& frame)
+{
+    auto next_row = std::size_t{0};
+
+    for (auto r = 0; r < Board::rows; ++r) {
+        if (not(frame.changed_rows & (Board::RowSet{1} << r))) {
+            continue;
+        }
+
+        auto const& row = frame.rows[next_row++];
+        auto same = true;
+
+        for (auto c = 0; c < Board::columns; ++c) {
+            same = same and board_[{r, c}] == row[static_cast<std::size_t>(c)];
+        }
+
+        if (not same) {
+            board_.load_row(r, row);
+        }
+    }
+
+    falling_.index = frame.tetrimino;
+    falling_.rotation = static_cast<geom::Rotation>(frame.rotation);
+    falling_.position = {frame.row, frame.column};
+    lines_ = frame.lines;
+    game_over_ = frame.game_over;
+
+    if (frame.changed_rows == Board::all_rows) {
+        synced_ = true;
+    }
+}
+
+}
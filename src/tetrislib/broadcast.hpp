@@ -0,0 +1,189 @@
+#ifndef TETRIS_BROADCAST_HPP
+#define TETRIS_BROADCAST_HPP
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "board.hpp"
+#include "shared_memory.hpp"
+#include "tetris.hpp"
+
+// Streaming a game to read-only viewers in other processes.
+//
+// The publisher writes frames to a ring in shared memory: a header followed by
+// `broadcast_capacity` fixed-size slots. A frame holds only the board rows
+// that changed since the previous one, plus the falling tetrimino and the
+// game's counters. Every `keyframe_interval` frames, one holds the whole
+// board instead.
+//
+// There is a single producer and any number of consumers, none of which write
+// to the ring, so viewers cost the publisher nothing. Each slot carries the
+// number of the frame in it, cleared while the slot is rewritten: a viewer
+// that finds another number after copying a frame was overrun, and resumes
+// from the latest keyframe, as a viewer that just started does.
+
+namespace tetris {
+
+// Frames the ring holds. Must leave a keyframe in the ring at all times, with
+// room for viewers to catch up from it.
+constexpr auto broadcast_capacity = 256;
+
+// Frames from one keyframe to the next.
+constexpr auto keyframe_interval = 64;
+
+static_assert(broadcast_capacity >= 2 * keyframe_interval);
+
+// Signals shared memory that doesn't hold a broadcast this build can read.
+struct BroadcastError: std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+// One frame of a broadcast, as laid out in shared memory.
+struct BroadcastFrame {
+    // Rows whose blocks follow. A keyframe has all of them.
+    Board::RowSet changed_rows;
+
+    // The falling tetrimino, as in `Observation`.
+    std::uint8_t tetrimino;
+    std::uint8_t rotation;
+    std::int8_t row;
+    std::int8_t column;
+
+    std::uint8_t game_over;
+    std::int32_t lines;
+
+    // Blocks of the changed rows, from top to bottom. Only as many entries as
+    // there are changed rows are written or read.
+    std::array<Board::RowBlocks, Board::rows> rows;
+};
+
+// Publishes a game's frames under a shared memory name.
+class BroadcastPublisher {
+public:
+    // Create the ring, replacing any broadcast left under the same name. It
+    // is removed when the publisher is destroyed.
+    //
+    // Args:
+    //     name: Shared memory name, such as "/tetris".
+    //
+    // Throws:
+    //     std::system_error: If the shared memory can't be created.
+    explicit BroadcastPublisher(std::string name);
+
+    // Publish what changed in a game since the last call, typically once per
+    // tick. Nothing is published if nothing changed, unless a keyframe is due.
+    //
+    // Only the game's dirty rows are compared with what viewers were sent, so
+    // its dirty rows must not be cleared between a change and the next call.
+    // Drawing the game right after publishing it, as renderers clear dirty
+    // rows, keeps to that.
+    void publish(Tetris const& game);
+
+private:
+    util::SharedMemory memory_;
+
+    // Number of the next frame; frames are numbered from 1.
+    std::uint64_t next_ = 1;
+
+    // What the viewers were last sent.
+    std::array<Board::RowBlocks, Board::rows> rows_{};
+    // Staging for the next frame, reused between calls.
+    BroadcastFrame frame_{};
+    FallingTetrimino falling_;
+    int lines_ = 0;
+    bool game_over_ = false;
+};
+
+// Follows a broadcast, keeping a copy of the game it shows.
+//
+// Exposes the same view of the game as `Tetris`, including its dirty rows, so
+// that it can be drawn the same way.
+class BroadcastViewer {
+public:
+    // Open a broadcast. Nothing is shown until a keyframe is read.
+    //
+    // Args:
+    //     name: The name the broadcast was published under.
+    //
+    // Throws:
+    //     std::system_error: If there is no such shared memory.
+    //     BroadcastError: If it doesn't hold a broadcast this build can read.
+    explicit BroadcastViewer(std::string name);
+
+    // Apply the frames published since the last call.
+    //
+    // Returns:
+    //     Whether any frame was applied.
+    bool poll();
+
+    // Whether a keyframe was read, i.e. whether the copy holds a game.
+    bool synced() const
+    {
+        return synced_;
+    }
+
+    bool is_over() const
+    {
+        return game_over_;
+    }
+
+    Board const& board() const
+    {
+        return board_;
+    }
+
+    FallingTetrimino const& falling_tetrimino() const
+    {
+        return falling_;
+    }
+
+    int lines() const
+    {
+        return lines_;
+    }
+
+    // See `Tetris::dirty_rows`. Nothing is dirty until `synced()`.
+    Board::RowSet dirty_rows() const
+    {
+        if (not synced_) {
+            return 0;
+        }
+
+        return board_.dirty_rows() |
+               covered_rows<StandardRules>(shown_) |
+               covered_rows<StandardRules>(falling_);
+    }
+
+    // See `Tetris::clear_dirty_rows`.
+    void clear_dirty_rows()
+    {
+        board_.clear_dirty_rows();
+        shown_ = falling_;
+    }
+
+private:
+    void apply(BroadcastFrame const& frame);
+
+    util::SharedMemory memory_;
+
+    // Number of the next frame to apply, or 0 to start over from the latest
+    // keyframe.
+    std::uint64_t next_ = 0;
+    bool synced_ = false;
+
+    // Copy of the frame being applied, reused between calls.
+    BroadcastFrame frame_{};
+
+    Board board_;
+    FallingTetrimino falling_;
+    // The falling tetrimino as of the last `clear_dirty_rows`.
+    FallingTetrimino shown_;
+    int lines_ = 0;
+    bool game_over_ = false;
+};
+
+}
+
+#endif
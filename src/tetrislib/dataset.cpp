@@ -0,0 +1,579 @@
+#include "dataset.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+constexpr char magic[] = {'T', 'D', 'S', 'T'};
+constexpr auto format_version = std::uint32_t{1};
+
+// Every field of `DatasetChunk` is a column, and so is each board row.
+constexpr auto column_count = std::size_t{8 + tetris::Board::rows};
+
+// Byte sizes of the fixed parts of a file.
+constexpr auto header_size = std::size_t{16};
+constexpr auto footer_size = std::size_t{16};
+constexpr auto index_entry_size = std::size_t{24};
+
+// Zero runs shorter than this are cheaper to keep in a literal run.
+constexpr auto min_zero_run = std::size_t{3};
+
+// Call `f` with each column of a chunk, in file order.
+template <typename Chunk, typename F> void for_each_column(Chunk& chunk, F f)
+{
+    f(chunk.games);
+    f(chunk.ticks);
+
+    for (auto& row: chunk.board) {
+        f(row);
+    }
+
+    f(chunk.tetriminoes);
+    f(chunk.rotations);
+    f(chunk.rows);
+    f(chunk.columns);
+    f(chunk.actions);
+    f(chunk.rewards);
+}
+
+template <typename T> void put(std::vector<unsigned char>& out, T value)
+{
+    auto bytes = std::array<unsigned char, sizeof(T)>{};
+    std::memcpy(bytes.data(), &value, sizeof(T));
+    out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+template <typename T> T get(unsigned char const* data)
+{
+    auto value = T{};
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+void put_varint(std::vector<unsigned char>& out, std::uint64_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<unsigned char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+std::uint64_t
+get_varint(unsigned char const*& data, unsigned char const* end)
+{
+    auto value = std::uint64_t{0};
+
+    for (auto shift = 0; shift < 64 and data != end; shift += 7) {
+        auto byte = *data++;
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+
+    throw tetris::DatasetError{"Dataset has a truncated or overlong integer."};
+}
+
+// XOR each value's bytes with the previous value's, the first with zeros.
+template <typename T>
+void delta_bytes(std::vector<T> const& column, std::vector<unsigned char>& out)
+{
+    out.resize(column.size() * sizeof(T));
+    std::memcpy(out.data(), column.data(), out.size());
+
+    for (auto i = out.size(); i-- > sizeof(T);) {
+        out[i] ^= out[i - sizeof(T)];
+    }
+}
+
+// Append the zero-run encoding of some bytes.
+void encode_runs(
+    std::vector<unsigned char> const& bytes,
+    std::vector<unsigned char>& out)
+{
+    auto i = std::size_t{0};
+    auto size = bytes.size();
+
+    while (i < size) {
+        auto zeros_start = i;
+
+        while (i < size and bytes[i] == 0) {
+            ++i;
+        }
+
+        auto literals_start = i;
+
+        // Stop the literals at the next zero run worth its own run.
+        while (i < size) {
+            auto zeros_end = i;
+
+            while (zeros_end < size and bytes[zeros_end] == 0 and
+                   zeros_end - i < min_zero_run) {
+                ++zeros_end;
+            }
+
+            if (zeros_end == i) {
+                ++i;
+            } else if (zeros_end - i >= min_zero_run or zeros_end == size) {
+                break;
+            } else {
+                i = zeros_end;
+            }
+        }
+
+        put_varint(out, literals_start - zeros_start);
+        put_varint(out, i - literals_start);
+        out.insert(
+            out.end(),
+            bytes.begin() + static_cast<std::ptrdiff_t>(literals_start),
+            bytes.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+}
+
+// Inverse of `encode_runs` followed by `delta_bytes`.
+template <typename T>
+void decode_column(
+    unsigned char const* data,
+    unsigned char const* end,
+    std::size_t rows,
+    std::vector<T>& column)
+{
+    thread_local auto bytes = std::vector<unsigned char>{};
+    bytes.assign(rows * sizeof(T), 0);
+
+    auto filled = std::size_t{0};
+
+    while (data != end) {
+        auto zeros = get_varint(data, end);
+        auto literals = get_varint(data, end);
+
+        if (zeros > bytes.size() - filled or
+            literals > bytes.size() - filled - zeros or
+            literals > static_cast<std::uint64_t>(end - data)) {
+            throw tetris::DatasetError{"Dataset column overflows its chunk."};
+        }
+
+        filled += zeros;
+        std::memcpy(bytes.data() + filled, data, literals);
+        filled += literals;
+        data += literals;
+    }
+
+    if (filled != bytes.size()) {
+        throw tetris::DatasetError{"Dataset column is truncated."};
+    }
+
+    for (auto i = sizeof(T); i < bytes.size(); ++i) {
+        bytes[i] ^= bytes[i - sizeof(T)];
+    }
+
+    column.resize(rows);
+    std::memcpy(column.data(), bytes.data(), bytes.size());
+}
+
+}
+
+namespace tetris {
+
+void DatasetChunk::push(DatasetRow const& row)
+{
+    games.push_back(row.game);
+    ticks.push_back(row.tick);
+
+    for (auto r = std::size_t{0}; r < board.size(); ++r) {
+        board[r].push_back(row.board[r]);
+    }
+
+    tetriminoes.push_back(row.tetrimino);
+    rotations.push_back(row.rotation);
+    rows.push_back(row.row);
+    columns.push_back(row.column);
+    actions.push_back(static_cast<std::uint8_t>(row.action));
+    rewards.push_back(row.reward);
+}
+
+DatasetRow DatasetChunk::row(std::size_t index) const
+{
+    auto row = DatasetRow{};
+    row.game = games[index];
+    row.tick = ticks[index];
+
+    for (auto r = std::size_t{0}; r < board.size(); ++r) {
+        row.board[r] = board[r][index];
+    }
+
+    row.tetrimino = tetriminoes[index];
+    row.rotation = rotations[index];
+    row.row = rows[index];
+    row.column = columns[index];
+    row.action = static_cast<Input>(actions[index]);
+    row.reward = rewards[index];
+
+    return row;
+}
+
+void DatasetChunk::clear()
+{
+    for_each_column(*this, [](auto& column) { column.clear(); });
+}
+
+DatasetWriter::DatasetWriter(std::string const& path):
+    out_{path, std::ios::binary | std::ios::trunc}
+{
+    if (not out_) {
+        throw DatasetError{"Can't create dataset " + path + "."};
+    }
+
+    auto header = std::vector<unsigned char>{magic, magic + sizeof(magic)};
+    put(header, format_version);
+    put(header, std::uint32_t{Board::rows});
+    put(header, std::uint32_t{Board::columns});
+
+    out_.write(
+        reinterpret_cast<char const*>(header.data()),
+        static_cast<std::streamsize>(header.size()));
+    offset_ = header.size();
+
+    io_ = std::thread{[this] { run_io(); }};
+}
+
+DatasetWriter::~DatasetWriter()
+{
+    try {
+        close();
+    } catch (...) {
+    }
+
+    // `close` stops the I/O thread even when it throws, but destroying a
+    // running thread would terminate the program, so make sure.
+    stop_io();
+}
+
+void DatasetWriter::advance(
+    std::uint32_t game_id,
+    std::uint32_t tick,
+    Tetris& game,
+    Input input)
+{
+    auto row = DatasetRow{};
+    row.game = game_id;
+    row.tick = tick;
+
+    for (auto r = 0; r < Board::rows; ++r) {
+        row.board[static_cast<std::size_t>(r)] = game.board().row_cells(r);
+    }
+
+    auto const& falling = game.falling_tetrimino();
+    row.tetrimino = falling.index;
+    row.rotation = static_cast<std::uint8_t>(falling.rotation);
+    row.row = static_cast<std::int8_t>(falling.position.row);
+    row.column = static_cast<std::int8_t>(falling.position.column);
+    row.action = input;
+
+    auto lines = game.lines();
+    game.advance(input);
+    row.reward = static_cast<float>(game.lines() - lines);
+
+    push(row);
+}
+
+void DatasetWriter::push(DatasetRow const& row)
+{
+    if (failed_) {
+        auto lock = std::lock_guard{mutex_};
+        rethrow_error();
+    }
+
+    filling_.push(row);
+
+    if (filling_.size() >= dataset_chunk_rows) {
+        auto lock = std::unique_lock{mutex_};
+        hand_off(lock);
+    }
+}
+
+void DatasetWriter::close()
+{
+    if (closed_) {
+        return;
+    }
+
+    closed_ = true;
+
+    // The I/O thread has to be stopped whether the last chunk can be handed
+    // off or not, so its error is only thrown after that.
+    auto error = std::exception_ptr{};
+
+    {
+        auto lock = std::unique_lock{mutex_};
+
+        if (filling_.size() > 0) {
+            try {
+                hand_off(lock);
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }
+    }
+
+    stop_io();
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    rethrow_error();
+
+    // The I/O thread is done, so the index is this thread's to write.
+    auto footer = std::vector<unsigned char>{};
+
+    for (auto const& entry: index_) {
+        put(footer, entry.offset);
+        put(footer, entry.size);
+        put(footer, entry.rows);
+        put(footer, entry.min_game);
+        put(footer, entry.max_game);
+    }
+
+    put(footer, offset_);
+    put(footer, static_cast<std::uint32_t>(index_.size()));
+    footer.insert(footer.end(), magic, magic + sizeof(magic));
+
+    out_.write(
+        reinterpret_cast<char const*>(footer.data()),
+        static_cast<std::streamsize>(footer.size()));
+    out_.close();
+
+    if (not out_) {
+        throw DatasetError{"Writing the dataset index failed."};
+    }
+}
+
+void DatasetWriter::hand_off(std::unique_lock<std::mutex>& lock)
+{
+    changed_.wait(lock, [this] { return not pending_ or error_; });
+
+    // No later chunk can make it to the file, so drop the rows rather than
+    // keep collecting them.
+    if (error_) {
+        filling_.clear();
+        failed_ = true;
+        rethrow_error();
+    }
+
+    std::swap(filling_, writing_);
+    filling_.clear();
+    pending_ = true;
+    changed_.notify_all();
+}
+
+void DatasetWriter::stop_io()
+{
+    {
+        auto lock = std::lock_guard{mutex_};
+        closing_ = true;
+    }
+
+    changed_.notify_all();
+
+    if (io_.joinable()) {
+        io_.join();
+    }
+}
+
+void DatasetWriter::run_io()
+{
+    auto lock = std::unique_lock{mutex_};
+
+    while (true) {
+        changed_.wait(lock, [this] { return pending_ or closing_; });
+
+        if (pending_) {
+            // `writing_` is this thread's until `pending_` is cleared.
+            lock.unlock();
+            auto error = std::exception_ptr{};
+
+            try {
+                write_chunk(writing_);
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            lock.lock();
+            pending_ = false;
+            error_ = error_ ? error_ : error;
+            changed_.notify_all();
+        } else {
+            return;
+        }
+    }
+}
+
+void DatasetWriter::write_chunk(DatasetChunk const& chunk)
+{
+    encoded_.clear();
+    put(encoded_, static_cast<std::uint32_t>(chunk.size()));
+
+    auto sizes_at = encoded_.size();
+    encoded_.resize(sizes_at + column_count * sizeof(std::uint32_t));
+
+    auto column = std::size_t{0};
+
+    for_each_column(
+        chunk,
+        [&](auto const& values)
+        {
+            auto start = encoded_.size();
+            delta_bytes(values, delta_);
+            encode_runs(delta_, encoded_);
+
+            auto size = static_cast<std::uint32_t>(encoded_.size() - start);
+            std::memcpy(
+                encoded_.data() + sizes_at + column++ * sizeof(size),
+                &size,
+                sizeof(size));
+        });
+
+    out_.write(
+        reinterpret_cast<char const*>(encoded_.data()),
+        static_cast<std::streamsize>(encoded_.size()));
+
+    if (not out_) {
+        throw DatasetError{"Writing a dataset chunk failed."};
+    }
+
+    auto [min_game, max_game] =
+        std::minmax_element(chunk.games.begin(), chunk.games.end());
+
+    index_.push_back(
+        {offset_,
+         static_cast<std::uint32_t>(encoded_.size()),
+         static_cast<std::uint32_t>(chunk.size()),
+         *min_game,
+         *max_game});
+    offset_ += encoded_.size();
+}
+
+void DatasetWriter::rethrow_error()
+{
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+DatasetReader::DatasetReader(std::string const& path): file_{path}
+{
+    auto data = file_.data();
+    auto size = file_.size();
+
+    if (size < header_size + footer_size or
+        std::memcmp(data, magic, sizeof(magic)) != 0 or
+        std::memcmp(data + size - sizeof(magic), magic, sizeof(magic)) != 0) {
+        throw DatasetError{"Not a dataset, or an unfinished one."};
+    }
+
+    if (get<std::uint32_t>(data + 4) != format_version or
+        get<std::uint32_t>(data + 8) != Board::rows or
+        get<std::uint32_t>(data + 12) != Board::columns) {
+        throw DatasetError{"Dataset was written with another layout."};
+    }
+
+    auto index_offset = get<std::uint64_t>(data + size - footer_size);
+    auto chunks = get<std::uint32_t>(data + size - footer_size + 8);
+
+    if (index_offset < header_size or index_offset > size or
+        index_offset + chunks * index_entry_size != size - footer_size) {
+        throw DatasetError{"Dataset index is malformed."};
+    }
+
+    index_.reserve(chunks);
+
+    for (auto entry = data + index_offset; entry != data + size - footer_size;
+         entry += index_entry_size) {
+        auto chunk = DatasetChunkIndex{
+            get<std::uint64_t>(entry),
+            get<std::uint32_t>(entry + 8),
+            get<std::uint32_t>(entry + 12),
+            get<std::uint32_t>(entry + 16),
+            get<std::uint32_t>(entry + 20),
+        };
+
+        if (chunk.offset < header_size or
+            chunk.offset + chunk.size > index_offset) {
+            throw DatasetError{"Dataset index is malformed."};
+        }
+
+        index_.push_back(chunk);
+    }
+}
+
+std::uint64_t DatasetReader::size() const
+{
+    auto rows = std::uint64_t{0};
+
+    for (auto const& chunk: index_) {
+        rows += chunk.rows;
+    }
+
+    return rows;
+}
+
+void DatasetReader::read_chunk(std::size_t chunk, DatasetChunk& out) const
+{
+    auto const& entry = index_[chunk];
+    auto data = file_.data() + entry.offset;
+    auto end = data + entry.size;
+    auto header = sizeof(std::uint32_t) * (1 + column_count);
+
+    if (entry.size < header or get<std::uint32_t>(data) != entry.rows) {
+        throw DatasetError{"Dataset chunk header is malformed."};
+    }
+
+    auto sizes = data + sizeof(std::uint32_t);
+    auto column_data = data + header;
+    auto column = std::size_t{0};
+
+    for_each_column(
+        out,
+        [&](auto& values)
+        {
+            auto size =
+                get<std::uint32_t>(sizes + column++ * sizeof(std::uint32_t));
+
+            if (size > static_cast<std::size_t>(end - column_data)) {
+                throw DatasetError{"Dataset column overflows its chunk."};
+            }
+
+            decode_column(column_data, column_data + size, entry.rows, values);
+            column_data += size;
+        });
+}
+
+std::optional<DatasetRow>
+DatasetReader::find(std::uint32_t game, std::uint32_t tick) const
+{
+    auto chunk = DatasetChunk{};
+
+    for (auto i = std::size_t{0}; i < index_.size(); ++i) {
+        if (game < index_[i].min_game or game > index_[i].max_game) {
+            continue;
+        }
+
+        read_chunk(i, chunk);
+
+        for (auto row = std::size_t{0}; row < chunk.size(); ++row) {
+            if (chunk.games[row] == game and chunk.ticks[row] == tick) {
+                return chunk.row(row);
+            }
+        }
+    }
+
+    return std::nullopt;
+}
+
+}
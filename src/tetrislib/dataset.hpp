@@ -0,0 +1,233 @@
+#ifndef TETRIS_DATASET_HPP
+#define TETRIS_DATASET_HPP
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "board.hpp"
+#include "mapped_file.hpp"
+#include "tetris.hpp"
+
+// Columnar files of (board, piece, action, reward) rows, one row per tick of
+// a recorded game.
+//
+// Rows are stored in chunks of up to `dataset_chunk_rows` rows. Within a
+// chunk, each field is its own column, and each board row is a column of its
+// own. A column is encoded by XOR-ing every value with the one before it,
+// which turns values that rarely change from tick to tick into zeros, and then
+// run-length encoding the zero bytes.
+//
+// Binary layout, all integers being little-endian:
+//
+//     "TDST" magic
+//     u32 format version
+//     u32 board rows
+//     u32 board columns
+//     chunks, each:
+//         u32 rows
+//         u32 encoded size of each column, in `DatasetChunk` field order
+//         the encoded columns, each a sequence of runs:
+//             varint count of zero bytes
+//             varint count of literal bytes, followed by those bytes
+//     index, one `DatasetChunkIndex` per chunk
+//     u64 index offset
+//     u32 chunk count
+//     "TDST" magic
+//
+// Varints are unsigned LEB128, as in replays.
+
+namespace tetris {
+
+// Rows a chunk holds, except maybe the last one.
+constexpr auto dataset_chunk_rows = std::size_t{4096};
+
+// Signals a malformed dataset, or one that couldn't be written.
+struct DatasetError: std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+// One tick of a recorded game.
+struct DatasetRow {
+    std::uint32_t game;
+    std::uint32_t tick;
+
+    // Occupancy before the tick, bit `c` of row `r` standing for column `c`.
+    std::array<Board::RowBits, Board::rows> board;
+
+    // The falling tetrimino before the tick, as in `Observation`.
+    std::uint8_t tetrimino;
+    std::uint8_t rotation;
+    std::int8_t row;
+    std::int8_t column;
+
+    Input action;
+
+    // Lines the tick cleared.
+    float reward;
+};
+
+// The rows of a chunk, column by column.
+struct DatasetChunk {
+    std::vector<std::uint32_t> games;
+    std::vector<std::uint32_t> ticks;
+    std::array<std::vector<Board::RowBits>, Board::rows> board;
+    std::vector<std::uint8_t> tetriminoes;
+    std::vector<std::uint8_t> rotations;
+    std::vector<std::int8_t> rows;
+    std::vector<std::int8_t> columns;
+    std::vector<std::uint8_t> actions;
+    std::vector<float> rewards;
+
+    std::size_t size() const
+    {
+        return games.size();
+    }
+
+    void push(DatasetRow const& row);
+    DatasetRow row(std::size_t index) const;
+    void clear();
+};
+
+// Where a chunk is in a dataset file and which games it holds.
+struct DatasetChunkIndex {
+    std::uint64_t offset;
+    std::uint32_t size;
+    std::uint32_t rows;
+    std::uint32_t min_game;
+    std::uint32_t max_game;
+};
+
+// Streams rows to a dataset file.
+//
+// Rows are collected into a chunk in memory. Full chunks are handed to a
+// background thread, which encodes and writes them while the next chunk
+// fills, so recording only waits on the disk if it falls a whole chunk
+// behind.
+//
+// A writer may only be used from one thread at a time. Simulation threads
+// that each need to record should each have their own writer and file.
+class DatasetWriter {
+public:
+    // Create a dataset file, replacing any file at `path`.
+    //
+    // Throws:
+    //     DatasetError: If the file can't be created.
+    explicit DatasetWriter(std::string const& path);
+
+    // Finishes the file like `close`, ignoring errors.
+    ~DatasetWriter();
+
+    DatasetWriter(DatasetWriter const&) = delete;
+    DatasetWriter& operator=(DatasetWriter const&) = delete;
+
+    // Record a game's state and an input, then advance the game with it.
+    //
+    // Args:
+    //     game_id: Identifies the game in the dataset.
+    //     tick: The game's tick, counting from 0.
+    //     game: The game being recorded.
+    //     input: The input for this tick.
+    //
+    // Throws:
+    //     DatasetError: If writing an earlier chunk failed.
+    void advance(
+        std::uint32_t game_id,
+        std::uint32_t tick,
+        Tetris& game,
+        Input input);
+
+    // Append a row.
+    //
+    // Throws:
+    //     DatasetError: If writing an earlier chunk failed. Once it has,
+    //                   every later push throws and drops its row.
+    void push(DatasetRow const& row);
+
+    // Write the remaining rows and the index, and close the file. Rows can't
+    // be pushed afterwards.
+    //
+    // Throws:
+    //     DatasetError: If writing failed.
+    void close();
+
+private:
+    // Hand the chunk being filled to the I/O thread.
+    void hand_off(std::unique_lock<std::mutex>& lock);
+    // Let the I/O thread write the chunk it was handed, then join it.
+    void stop_io();
+    void run_io();
+    void write_chunk(DatasetChunk const& chunk);
+    void rethrow_error();
+
+    std::ofstream out_;
+    std::uint64_t offset_ = 0;
+    std::vector<DatasetChunkIndex> index_;
+    // Scratch space of the I/O thread.
+    std::vector<unsigned char> encoded_;
+    std::vector<unsigned char> delta_;
+
+    DatasetChunk filling_;
+    DatasetChunk writing_;
+
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    // Whether `writing_` holds a chunk the I/O thread hasn't written yet.
+    bool pending_ = false;
+    bool closing_ = false;
+    bool closed_ = false;
+    // Whether `push` saw `error_`, so that it doesn't need the lock to know.
+    bool failed_ = false;
+    std::exception_ptr error_;
+    std::thread io_;
+};
+
+// Reads a dataset file, mapped into memory.
+class DatasetReader {
+public:
+    // Throws:
+    //     std::system_error: If the file can't be opened.
+    //     DatasetError: If it isn't a dataset this build can read.
+    explicit DatasetReader(std::string const& path);
+
+    std::vector<DatasetChunkIndex> const& index() const
+    {
+        return index_;
+    }
+
+    // Total number of rows.
+    std::uint64_t size() const;
+
+    // Decode a chunk.
+    //
+    // Args:
+    //     chunk: The chunk's position in `index()`.
+    //     out: Where to decode it.
+    //
+    // Throws:
+    //     DatasetError: If the chunk is malformed.
+    void read_chunk(std::size_t chunk, DatasetChunk& out) const;
+
+    // Look up the row of a game's tick, decoding only the chunks that may
+    // hold the game.
+    //
+    // Throws:
+    //     DatasetError: If a chunk is malformed.
+    std::optional<DatasetRow> find(std::uint32_t game, std::uint32_t tick) const;
+
+private:
+    util::MappedFile file_;
+    std::vector<DatasetChunkIndex> index_;
+};
+
+}
+
+#endif
@@ -0,0 +1,183 @@
+#include "features.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+
+#include "assert.hpp"
+#include "bits.hpp"
+
+namespace {
+
+// Count the set bits of each 16-bit lane, leaving each count in its lane.
+constexpr std::uint64_t lane_popcount(std::uint64_t lanes)
+{
+    lanes -= (lanes >> 1) & 0x5555'5555'5555'5555;
+    lanes = (lanes & 0x3333'3333'3333'3333) +
+            ((lanes >> 2) & 0x3333'3333'3333'3333);
+    lanes = (lanes + (lanes >> 4)) & 0x0F0F'0F0F'0F0F'0F0F;
+    return (lanes + (lanes >> 8)) & 0x00FF'00FF'00FF'00FF;
+}
+
+int lane(std::uint64_t lanes, int index)
+{
+    return static_cast<int>((lanes >> (16 * index)) & 0xFFFF);
+}
+
+}
+
+namespace tetris {
+
+template <typename Rules>
+BoardFeatures compute_features(BasicBoard<Rules> const& board)
+{
+    constexpr auto rows = BasicBoard<Rules>::rows;
+    constexpr auto columns = BasicBoard<Rules>::columns;
+    constexpr auto wall_width = BasicBoard<Rules>::wall_width;
+
+    // Bit `c` for each column `c`.
+    constexpr auto all_columns = (1u << columns) - 1u;
+    // Pairs of neighbouring bits across the playfield and one wall bit on
+    // each side, each pair marked by its lower bit.
+    constexpr auto row_pairs = ((1u << (columns + 1)) - 1u)
+                               << (wall_width - 1);
+
+    auto features = BoardFeatures{};
+    auto heights = std::array<int, columns>{};
+    auto well_runs = std::array<int, columns>{};
+
+    // Per-row bit counts are summed four at a time, one per 16-bit lane:
+    // holes, covered columns, row transitions and column transitions. Lanes
+    // can't overflow: each row adds at most 16 to each, and boards have
+    // fewer than 64 rows.
+    auto counts = std::uint64_t{0};
+
+    // Columns with a block in or above the current row.
+    auto covered = 0u;
+    auto previous_cells = 0u;
+    auto previous_wells = 0u;
+
+    for (auto row = 0; row < rows; ++row) {
+        auto bits = unsigned{board.row_bits(row)};
+        auto cells = (bits >> wall_width) & all_columns;
+
+        for (auto tops = cells & ~covered; tops; tops &= tops - 1) {
+            heights[static_cast<std::size_t>(util::countr_zero(tops))] =
+                rows - row;
+        }
+
+        if (cells and not covered) {
+            features.max_height = rows - row;
+        }
+
+        auto holes = covered & ~cells;
+        features.rows_with_holes += holes != 0;
+        covered |= cells;
+
+        auto row_transitions = (bits ^ (bits >> 1)) & row_pairs;
+        auto column_transitions = row > 0 ? previous_cells ^ cells : 0u;
+        previous_cells = cells;
+
+        counts += lane_popcount(
+            std::uint64_t{holes} | std::uint64_t{covered} << 16 |
+            std::uint64_t{row_transitions} << 32 |
+            std::uint64_t{column_transitions} << 48);
+
+        // Open empty blocks whose neighbours, walls included, are filled.
+        auto wells = ((~bits & (bits << 1) & (bits >> 1)) >> wall_width) &
+                     all_columns & ~covered;
+
+        for (auto ended = previous_wells & ~wells; ended;
+             ended &= ended - 1) {
+            well_runs[static_cast<std::size_t>(util::countr_zero(ended))] = 0;
+        }
+
+        for (auto open = wells; open; open &= open - 1) {
+            auto& run =
+                well_runs[static_cast<std::size_t>(util::countr_zero(open))];
+            features.cumulative_wells += ++run;
+        }
+
+        previous_wells = wells;
+    }
+
+    features.holes = lane(counts, 0);
+    features.aggregate_height = lane(counts, 1);
+    features.row_transitions = lane(counts, 2);
+    features.column_transitions = lane(counts, 3);
+
+    // The floor is filled.
+    features.column_transitions += util::popcount(previous_cells ^ all_columns);
+
+    for (auto c = std::size_t{0}; c + 1 < heights.size(); ++c) {
+        features.bumpiness += std::abs(heights[c] - heights[c + 1]);
+    }
+
+    return features;
+}
+
+template <typename Rules>
+void compute_features(
+    std::vector<BasicBoard<Rules>> const& boards,
+    std::vector<BoardFeatures>& features)
+{
+    features.resize(boards.size());
+
+    for (auto i = std::size_t{0}; i < boards.size(); ++i) {
+        features[i] = compute_features(boards[i]);
+    }
+}
+
+double LinearEvaluator::score(
+    BoardFeatures const& features,
+    int lines_cleared) const
+{
+    return weights_.aggregate_height * features.aggregate_height +
+           weights_.max_height * features.max_height +
+           weights_.holes * features.holes +
+           weights_.rows_with_holes * features.rows_with_holes +
+           weights_.bumpiness * features.bumpiness +
+           weights_.row_transitions * features.row_transitions +
+           weights_.column_transitions * features.column_transitions +
+           weights_.cumulative_wells * features.cumulative_wells +
+           weights_.lines_cleared * lines_cleared;
+}
+
+void LinearEvaluator::score(
+    std::vector<BoardFeatures> const& features,
+    std::vector<int> const& lines_cleared,
+    std::vector<double>& scores) const
+{
+    assertpp::assert_predicate(
+        [&] { return lines_cleared.size() == features.size(); },
+        "LinearEvaluator::score needs the lines cleared for every board.");
+
+    scores.resize(features.size());
+
+    for (auto i = std::size_t{0}; i < features.size(); ++i) {
+        scores[i] = score(features[i], lines_cleared[i]);
+    }
+}
+
+template BoardFeatures compute_features(
+    BasicBoard<StandardRules> const& board);
+template BoardFeatures compute_features(BasicBoard<TallRules> const& board);
+template BoardFeatures compute_features(
+    BasicBoard<CompactRules> const& board);
+template BoardFeatures compute_features(
+    BasicBoard<ModernRules> const& board);
+
+template void compute_features(
+    std::vector<BasicBoard<StandardRules>> const& boards,
+    std::vector<BoardFeatures>& features);
+template void compute_features(
+    std::vector<BasicBoard<TallRules>> const& boards,
+    std::vector<BoardFeatures>& features);
+template void compute_features(
+    std::vector<BasicBoard<CompactRules>> const& boards,
+    std::vector<BoardFeatures>& features);
+template void compute_features(
+    std::vector<BasicBoard<ModernRules>> const& boards,
+    std::vector<BoardFeatures>& features);
+
+}
@@ -0,0 +1,119 @@
+#ifndef TETRIS_FEATURES_HPP
+#define TETRIS_FEATURES_HPP
+
+#include <vector>
+
+#include "board.hpp"
+
+namespace tetris {
+
+// The usual hand-crafted features for scoring boards, as used by
+// Dellacherie-style and El-Tetris-style bots.
+//
+// A column's height is the number of rows from its topmost block down to the
+// floor. Walls and the floor count as filled; the space above the board does
+// not count at all.
+struct BoardFeatures {
+    // Sum of the column heights.
+    int aggregate_height = 0;
+    int max_height = 0;
+    // Empty blocks with a filled block somewhere above them.
+    int holes = 0;
+    // Rows with at least one hole.
+    int rows_with_holes = 0;
+    // Sum of the height differences between neighbouring columns.
+    int bumpiness = 0;
+    // Changes between filled and empty going along each row, walls included.
+    int row_transitions = 0;
+    // Changes between filled and empty going down each column, floor
+    // included.
+    int column_transitions = 0;
+    // Sum over the wells of 1 + 2 + ... + depth, where a well is a vertical
+    // run of empty blocks with both neighbours filled.
+    int cumulative_wells = 0;
+};
+
+// Compute every feature of a board in one pass over its occupancy bits.
+//
+// Rows are processed whole, with shifts and popcounts across columns; only
+// the first block of each column is visited on its own.
+template <typename Rules>
+BoardFeatures compute_features(BasicBoard<Rules> const& board);
+
+// Compute the features of many boards, e.g. every candidate placement of a
+// tetrimino.
+//
+// Args:
+//     boards: The boards.
+//     features: Where to write the features, in the same order. Resized to
+//               fit; its storage is reused between calls.
+template <typename Rules>
+void compute_features(
+    std::vector<BasicBoard<Rules>> const& boards,
+    std::vector<BoardFeatures>& features);
+
+// Weights of `LinearEvaluator`, one per feature of `BoardFeatures` plus one
+// for the lines a move cleared.
+struct FeatureWeights {
+    double aggregate_height = 0;
+    double max_height = 0;
+    double holes = 0;
+    double rows_with_holes = 0;
+    double bumpiness = 0;
+    double row_transitions = 0;
+    double column_transitions = 0;
+    double cumulative_wells = 0;
+    double lines_cleared = 0;
+};
+
+// Weights tuned by genetic search in Yiyuan Lee's "Tetris AI - The (Near)
+// Perfect Bot", over aggregate height, holes, bumpiness and lines.
+constexpr auto el_tetris_weights = FeatureWeights{
+    -0.510066, // aggregate_height
+    0,         // max_height
+    -0.35663,  // holes
+    0,         // rows_with_holes
+    -0.184483, // bumpiness
+    0,         // row_transitions
+    0,         // column_transitions
+    0,         // cumulative_wells
+    0.760666,  // lines_cleared
+};
+
+// Scores boards as a weighted sum of their features; higher is better.
+class LinearEvaluator {
+public:
+    explicit LinearEvaluator(FeatureWeights weights = el_tetris_weights):
+        weights_{weights}
+    {}
+
+    FeatureWeights const& weights() const
+    {
+        return weights_;
+    }
+
+    // Args:
+    //     features: Features of the board after a move.
+    //     lines_cleared: How many lines the move cleared.
+    double score(BoardFeatures const& features, int lines_cleared = 0) const;
+
+    // Score many boards at once.
+    //
+    // Args:
+    //     features: Features of each board.
+    //     lines_cleared: How many lines the move to each board cleared, in
+    //                    the same order.
+    //     scores: Where to write the scores, in the same order. Resized to
+    //             fit; its storage is reused between calls.
+    void score(
+        std::vector<BoardFeatures> const& features,
+        std::vector<int> const& lines_cleared,
+        std::vector<double>& scores) const;
+
+private:
+    FeatureWeights weights_;
+};
+
+}
+
+#endif
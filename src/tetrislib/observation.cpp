@@ -0,0 +1,29 @@
+#include "observation.hpp"
+
+namespace tetris {
+
+void observe(
+    Board const& board,
+    GameState const& state,
+    Observation& observation)
+{
+    for (auto row = 0; row < Board::rows; ++row) {
+        observation.rows[static_cast<std::size_t>(row)] = board.row_cells(row);
+    }
+
+    auto const& falling = state.falling;
+
+    observation.tetrimino = falling.index;
+    observation.rotation = static_cast<std::uint8_t>(falling.rotation);
+    observation.row = static_cast<std::int8_t>(falling.position.row);
+    observation.column = static_cast<std::int8_t>(falling.position.column);
+    observation.ticks = state.ticks;
+    observation.clearing_ticks = state.clearing_ticks;
+    observation.lines = state.lines;
+    observation.lock_ticks = state.lock_ticks;
+    observation.lock_resets = state.lock_resets;
+    observation.held_ticks = state.held_ticks;
+    observation.game_over = state.game_over;
+}
+
+}
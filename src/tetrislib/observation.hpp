@@ -0,0 +1,48 @@
+#ifndef TETRIS_OBSERVATION_HPP
+#define TETRIS_OBSERVATION_HPP
+
+#include <array>
+#include <cstdint>
+
+#include "board.hpp"
+#include "tetris.hpp"
+
+namespace tetris {
+
+// Fixed-layout summary of a game, meant to be handed to consumers outside the
+// engine in packed arrays. Trivially copyable and free of pointers.
+struct Observation {
+    // Occupancy of each row, bit `c` standing for column `c`.
+    std::array<Board::RowBits, Board::rows> rows;
+
+    // The falling tetrimino: its index in `tetriminoes`, its rotation and its
+    // shape's top-left corner on the board.
+    std::uint8_t tetrimino;
+    std::uint8_t rotation;
+    std::int8_t row;
+    std::int8_t column;
+
+    // `GameState` counters.
+    std::int32_t ticks;
+    std::int32_t clearing_ticks;
+    std::int32_t lines;
+    std::int32_t lock_ticks;
+    std::int32_t lock_resets;
+    std::int32_t held_ticks;
+    std::uint8_t game_over;
+};
+
+// Summarize a game.
+//
+// Args:
+//     board: The game's board.
+//     state: The game's state.
+//     observation: Where to write the summary.
+void observe(
+    Board const& board,
+    GameState const& state,
+    Observation& observation);
+
+}
+
+#endif
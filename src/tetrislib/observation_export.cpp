@@ -0,0 +1,209 @@
+#include "observation_export.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include "assert.hpp"
+
+namespace {
+
+constexpr auto export_magic = std::uint32_t{0x5342'4F54};
+constexpr auto export_version = std::uint32_t{2};
+
+struct Header {
+    // Set last, once the rest of the ring is ready.
+    std::atomic<std::uint32_t> magic;
+    std::uint32_t version;
+    std::uint32_t games;
+    std::uint32_t frames;
+    std::uint32_t rows;
+    std::uint32_t columns;
+    std::uint32_t observation_size;
+    std::uint32_t slot_size;
+    std::atomic<std::uint64_t> step;
+    std::uint8_t padding[24];
+};
+
+// Whole cache lines, so that writing one game never contends with reading
+// another.
+struct alignas(64) Slot {
+    std::atomic<std::uint64_t> sequence;
+    tetris::Observation observation;
+};
+
+// The layout is documented in the header, for consumers that don't share this
+// code; keep both in sync.
+static_assert(sizeof(Header) == 64 and offsetof(Header, step) == 32);
+static_assert(
+    offsetof(tetris::Observation, tetrimino) ==
+        sizeof(tetris::Board::RowBits) * tetris::Board::rows and
+    offsetof(tetris::Observation, ticks) ==
+        offsetof(tetris::Observation, tetrimino) + 4 and
+    offsetof(tetris::Observation, game_over) ==
+        offsetof(tetris::Observation, ticks) + 24);
+static_assert(sizeof(Slot) == 128, "A slot should fill two cache lines.");
+static_assert(
+    std::atomic<std::uint64_t>::is_always_lock_free and
+        std::atomic<std::uint32_t>::is_always_lock_free,
+    "Atomics in shared memory must not rely on process-local locks.");
+
+// Bytes of a ring, checking first that its sizes fit the header and memory.
+std::size_t ring_size(std::size_t games, int frames)
+{
+    if (frames < 1) {
+        throw tetris::ExportError{"An export needs at least one frame."};
+    }
+
+    auto const max_slots = (SIZE_MAX - sizeof(Header)) / sizeof(Slot);
+
+    if (games > UINT32_MAX or
+        games > max_slots / static_cast<std::size_t>(frames)) {
+        throw tetris::ExportError{"Too many observations to export."};
+    }
+
+    return sizeof(Header) +
+           games * static_cast<std::size_t>(frames) * sizeof(Slot);
+}
+
+Header const& header(util::SharedMemory const& memory)
+{
+    return *static_cast<Header const*>(memory.data());
+}
+
+// First slot of the frame holding a step.
+Slot const* frame(
+    util::SharedMemory const& memory,
+    std::size_t games,
+    int frames,
+    std::uint64_t step)
+{
+    auto slots = reinterpret_cast<Slot const*>(
+        static_cast<unsigned char const*>(memory.data()) + sizeof(Header));
+
+    return slots + (step - 1) % static_cast<std::uint64_t>(frames) * games;
+}
+
+}
+
+namespace tetris {
+
+ObservationExport::ObservationExport(
+    std::string name,
+    std::size_t games,
+    int frames):
+    memory_{std::move(name), ring_size(games, frames)},
+    games_{games},
+    frames_{frames}
+{
+    auto& ring_header = *new (memory_.data()) Header{};
+    ring_header.version = export_version;
+    ring_header.games = static_cast<std::uint32_t>(games_);
+    ring_header.frames = static_cast<std::uint32_t>(frames_);
+    ring_header.rows = Board::rows;
+    ring_header.columns = Board::columns;
+    ring_header.observation_size = sizeof(Observation);
+    ring_header.slot_size = sizeof(Slot);
+
+    auto slots = const_cast<Slot*>(frame(memory_, games_, frames_, 1));
+
+    for (auto i = std::size_t{0}; i < games_ * static_cast<std::size_t>(frames_);
+         ++i) {
+        new (&slots[i]) Slot{};
+    }
+
+    ring_header.magic.store(export_magic, std::memory_order_release);
+}
+
+void ObservationExport::write(std::vector<Observation> const& observations)
+{
+    assertpp::assert_predicate(
+        [&] { return observations.size() == games_; },
+        "ObservationExport::write needs one observation per game.");
+
+    auto step = ++step_;
+    auto slots = const_cast<Slot*>(frame(memory_, games_, frames_, step));
+
+    for (auto game = std::size_t{0}; game < games_; ++game) {
+        auto& slot = slots[game];
+
+        slot.sequence.store(2 * step - 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(
+            &slot.observation,
+            &observations[game],
+            sizeof(Observation));
+        slot.sequence.store(2 * step, std::memory_order_release);
+    }
+
+    static_cast<Header*>(memory_.data())
+        ->step.store(step, std::memory_order_release);
+}
+
+ObservationReader::ObservationReader(std::string name):
+    memory_{std::move(name)}, games_{0}, frames_{0}
+{
+    if (memory_.size() < sizeof(Header) or
+        header(memory_).magic.load(std::memory_order_acquire) !=
+            export_magic) {
+        throw ExportError{"Not an observation export."};
+    }
+
+    auto const& ring_header = header(memory_);
+    games_ = ring_header.games;
+    frames_ = static_cast<int>(ring_header.frames);
+
+    if (ring_header.version != export_version or
+        ring_header.rows != Board::rows or
+        ring_header.columns != Board::columns or
+        ring_header.observation_size != sizeof(Observation) or
+        ring_header.slot_size != sizeof(Slot) or frames_ < 1 or
+        memory_.size() < ring_size(games_, frames_)) {
+        throw ExportError{"Observations were exported by another build."};
+    }
+}
+
+std::uint64_t ObservationReader::read(
+    std::vector<Observation>& observations) const
+{
+    observations.resize(games_);
+
+    while (true) {
+        auto step = header(memory_).step.load(std::memory_order_acquire);
+
+        if (step == 0) {
+            return 0;
+        }
+
+        auto slots = frame(memory_, games_, frames_, step);
+        auto whole = true;
+
+        for (auto game = std::size_t{0}; whole and game < games_; ++game) {
+            auto const& slot = slots[game];
+
+            whole =
+                slot.sequence.load(std::memory_order_acquire) == 2 * step;
+
+            if (whole) {
+                std::memcpy(
+                    &observations[game],
+                    &slot.observation,
+                    sizeof(Observation));
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                whole = slot.sequence.load(std::memory_order_relaxed) ==
+                        2 * step;
+            }
+        }
+
+        // Lapped by the writer: the step read is gone, try the new last one.
+        if (whole) {
+            return step;
+        }
+    }
+}
+
+}
@@ -0,0 +1,113 @@
+#ifndef TETRIS_OBSERVATION_EXPORT_HPP
+#define TETRIS_OBSERVATION_EXPORT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "observation.hpp"
+#include "shared_memory.hpp"
+
+// Exporting the observations of a batch of games to other processes.
+//
+// Observations are written to shared memory with a fixed layout, so that a
+// consumer, such as a trainer in another language, can map it once and read
+// every step in place with no syscalls. All integers are little-endian.
+//
+//     Header, 64 bytes:
+//         u32 magic, "TOBS"
+//         u32 layout version
+//         u32 games
+//         u32 frames, the number of steps kept
+//         u32 rows of each board
+//         u32 columns of each board
+//         u32 observation size (see `Observation`)
+//         u32 slot size
+//         u64 last step written, counting from 1; 0 before the first
+//     Frames, in a ring: step `s` is in frame `(s - 1) % frames`.
+//         One slot per game, in game order, each a u64 sequence followed by
+//         an `Observation` and padded to 128 bytes, two cache lines.
+//
+// A slot's sequence is `2 * s - 1` while step `s` is being written to it and
+// `2 * s` once it is written. A consumer reads the last step from the header,
+// checks that the sequence is `2 * s`, reads the observation and checks the
+// sequence again: if it changed, the writer lapped the consumer and the
+// observation may be torn. With two frames or more, a consumer that keeps up
+// with the writer is never lapped.
+
+namespace tetris {
+
+// Signals an export too small or too large to create, or shared memory that
+// doesn't hold observations this build can read.
+struct ExportError: std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+// Writes observations to a ring of frames in shared memory.
+class ObservationExport {
+public:
+    // Create the ring, replacing any left under the same name. It is removed
+    // when the export is destroyed.
+    //
+    // Args:
+    //     name: Shared memory name, such as "/tetris-observations".
+    //     games: How many games each step has.
+    //     frames: How many steps the ring keeps, at least 1.
+    //
+    // Throws:
+    //     ExportError: If there are no frames, or too many observations to
+    //                  fit in memory. Nothing is created then.
+    //     std::system_error: If the shared memory can't be created.
+    ObservationExport(std::string name, std::size_t games, int frames = 2);
+
+    // Write the observations of a step, such as those `BatchEnv::observe`
+    // gathers.
+    //
+    // Args:
+    //     observations: One observation per game, in game order.
+    void write(std::vector<Observation> const& observations);
+
+private:
+    util::SharedMemory memory_;
+    std::size_t games_;
+    int frames_;
+    std::uint64_t step_ = 0;
+};
+
+// Reads the observations of an `ObservationExport`, typically from another
+// process.
+class ObservationReader {
+public:
+    // Args:
+    //     name: The name the export was created with.
+    //
+    // Throws:
+    //     std::system_error: If there is no such shared memory.
+    //     ExportError: If it doesn't hold observations this build can read.
+    explicit ObservationReader(std::string name);
+
+    std::size_t games() const
+    {
+        return games_;
+    }
+
+    // Copy the observations of the last step written.
+    //
+    // Args:
+    //     observations: Where to copy them, resized to `games()`.
+    //
+    // Returns:
+    //     The step they are from, or 0 if no step was written yet.
+    std::uint64_t read(std::vector<Observation>& observations) const;
+
+private:
+    util::SharedMemory memory_;
+    std::size_t games_;
+    int frames_;
+};
+
+}
+
+#endif
@@ -0,0 +1,128 @@
+#include "placements.hpp"
+
+#include <algorithm>
+
+namespace {
+
+constexpr auto moves = std::array{
+    tetris::Input::Left,
+    tetris::Input::Right,
+    tetris::Input::Rotate,
+    tetris::Input::Down,
+};
+
+}
+
+namespace tetris {
+
+PlacementFinder::PlacementFinder():
+    nodes_(static_cast<std::size_t>(node_count), Node{0, 0, Input::Nothing})
+{
+    queue_.reserve(static_cast<std::size_t>(node_count));
+}
+
+std::vector<Placement> const&
+PlacementFinder::find(Board const& board, FallingTetrimino const& start)
+{
+    placements_.clear();
+    footprints_.clear();
+    queue_.clear();
+
+    // Generation zero means "never seen", so skip it when wrapping around.
+    if (++generation_ == 0) {
+        std::fill(nodes_.begin(), nodes_.end(), Node{0, 0, Input::Nothing});
+        generation_ = 1;
+    }
+
+    auto const& tetrimino = start.tetrimino();
+
+    if (not board.piece_fits(tetrimino, start.position, start.rotation)) {
+        return placements_;
+    }
+
+    start_node_ = node_of(start);
+    nodes_[static_cast<std::size_t>(start_node_)] = {
+        generation_,
+        static_cast<std::uint16_t>(start_node_),
+        Input::Nothing,
+    };
+    queue_.push_back(static_cast<std::uint16_t>(start_node_));
+
+    for (auto next = std::size_t{0}; next < queue_.size(); ++next) {
+        auto node = queue_[next];
+        auto current = falling_at(start, node);
+
+        for (auto input: moves) {
+            auto moved = current;
+
+            if (not try_move(board, moved, input)) {
+                continue;
+            }
+
+            auto& visited = nodes_[static_cast<std::size_t>(node_of(moved))];
+
+            if (visited.generation != generation_) {
+                visited = {generation_, node, input};
+                queue_.push_back(static_cast<std::uint16_t>(node_of(moved)));
+            }
+        }
+
+        auto below = current.position + geom::Position{1, 0};
+
+        if (board.piece_fits(tetrimino, below, current.rotation)) {
+            continue;
+        }
+
+        auto const& layout = tetrimino.layout(current.rotation);
+        auto footprint = std::pair{
+            current.position.row + layout.min.row,
+            layout.row_masks << (current.position.column + margin),
+        };
+
+        if (std::find(footprints_.begin(), footprints_.end(), footprint) ==
+            footprints_.end()) {
+            footprints_.push_back(footprint);
+            placements_.push_back({current, node});
+        }
+    }
+
+    return placements_;
+}
+
+std::vector<Input> PlacementFinder::path_to(Placement const& placement) const
+{
+    auto path = std::vector<Input>{};
+
+    for (auto node = static_cast<int>(placement.node); node != start_node_;) {
+        auto const& visited = nodes_[static_cast<std::size_t>(node)];
+        path.push_back(visited.input);
+        node = visited.parent;
+    }
+
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+int PlacementFinder::node_of(FallingTetrimino const& falling)
+{
+    auto rotation = static_cast<int>(falling.rotation);
+    auto row = falling.position.row + margin;
+    auto column = falling.position.column + margin;
+
+    return (rotation * row_span + row) * column_span + column;
+}
+
+FallingTetrimino
+PlacementFinder::falling_at(FallingTetrimino const& prototype, int node)
+{
+    auto falling = prototype;
+
+    falling.position.column = node % column_span - margin;
+    node /= column_span;
+    falling.position.row = node % row_span - margin;
+    falling.rotation = static_cast<geom::Rotation>(node / row_span);
+
+    return falling;
+}
+
+}
@@ -0,0 +1,82 @@
+#ifndef TETRIS_PLACEMENTS_HPP
+#define TETRIS_PLACEMENTS_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "board.hpp"
+#include "tetris.hpp"
+
+namespace tetris {
+
+// Where a falling tetrimino ends up when it locks.
+struct Placement {
+    FallingTetrimino piece;
+
+    // Search node the placement was found at, for `PlacementFinder::path_to`.
+    std::uint16_t node;
+};
+
+// Finds every position a falling tetrimino can lock in.
+//
+// Runs a breadth-first search over (position, rotation) states, moving with
+// the same rules as `try_move`. Gravity is not simulated: every state the
+// tetrimino can move to is considered reachable. Placements that cover the
+// same blocks (such as an O in each of its rotations) are reported once.
+//
+// Scratch space is kept between calls, so reusing a finder doesn't allocate.
+class PlacementFinder {
+public:
+    PlacementFinder();
+
+    // Find the placements of a tetrimino.
+    //
+    // Args:
+    //     board: The board the tetrimino is falling on.
+    //     start: The tetrimino, where it currently is.
+    //
+    // Returns:
+    //     The placements, closest to `start` first. Only valid until the next
+    //     call.
+    std::vector<Placement> const&
+    find(Board const& board, FallingTetrimino const& start);
+
+    // Inputs that take the tetrimino from the last search's start to a
+    // placement. Once there, the tetrimino locks on the next gravity tick.
+    std::vector<Input> path_to(Placement const& placement) const;
+
+private:
+    // The search covers shapes whose top-left corner is up to `margin` rows
+    // or columns out of the board, enough for any 4x4 shape to have blocks
+    // inside.
+    constexpr static auto margin = 4;
+    constexpr static auto row_span = Board::rows + margin;
+    constexpr static auto column_span = Board::columns + margin;
+    constexpr static auto node_count = 4 * row_span * column_span;
+
+    struct Node {
+        std::uint32_t generation;
+        std::uint16_t parent;
+        Input input;
+    };
+
+    static int node_of(FallingTetrimino const& falling);
+    static FallingTetrimino
+    falling_at(FallingTetrimino const& prototype, int node);
+
+    std::vector<Node> nodes_;
+    std::vector<std::uint16_t> queue_;
+    std::vector<Placement> placements_;
+
+    // Board position of each placement's top block row, plus its blocks as
+    // row masks, to spot duplicates.
+    std::vector<std::pair<int, std::uint64_t>> footprints_;
+
+    std::uint32_t generation_ = 0;
+    int start_node_ = 0;
+};
+
+}
+
+#endif
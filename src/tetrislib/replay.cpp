@@ -0,0 +1,314 @@
+#include "replay.hpp"
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+
+namespace {
+
+constexpr char magic[] = {'T', 'R', 'P', 'L'};
+
+void write_varint(std::ostream& out, std::uint64_t value)
+{
+    while (value >= 0x80) {
+        out.put(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+
+    out.put(static_cast<char>(value));
+}
+
+std::uint64_t read_varint(std::istream& in)
+{
+    auto value = std::uint64_t{0};
+
+    for (auto shift = 0; shift < 64; shift += 7) {
+        auto byte = in.get();
+
+        if (byte == std::istream::traits_type::eof()) {
+            throw tetris::ReplayError{"Replay is truncated."};
+        }
+
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+
+    throw tetris::ReplayError{"Replay has an overlong integer."};
+}
+
+// Map signed integers to unsigned ones, small magnitudes to small values.
+std::uint64_t zigzag(std::int64_t value)
+{
+    return (static_cast<std::uint64_t>(value) << 1) ^
+           static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t value)
+{
+    return static_cast<std::int64_t>(value >> 1) ^
+           -static_cast<std::int64_t>(value & 1);
+}
+
+template <typename T>
+T read_bounded(std::istream& in, std::uint64_t max, const char* message)
+{
+    auto value = read_varint(in);
+
+    if (value > max) {
+        throw tetris::ReplayError{message};
+    }
+
+    return static_cast<T>(value);
+}
+
+}
+
+namespace tetris {
+
+std::int64_t Replay::ticks() const
+{
+    auto total = std::int64_t{0};
+
+    for (auto const& run: runs) {
+        total += run.length;
+    }
+
+    return total;
+}
+
+void write_replay(std::ostream& out, Replay const& replay)
+{
+    out.write(magic, sizeof(magic));
+    write_varint(out, replay.version);
+    write_varint(out, replay.seed);
+    write_varint(out, static_cast<std::uint64_t>(replay.randomizer));
+    write_varint(out, replay.stream);
+    write_varint(out, replay.runs.size());
+
+    for (auto const& run: replay.runs) {
+        write_varint(out, static_cast<std::uint64_t>(run.input));
+        write_varint(out, run.length);
+    }
+
+    write_varint(out, replay.placements.size());
+
+    auto tick = std::int64_t{0};
+
+    for (auto const& placement: replay.placements) {
+        auto const& landing = placement.landing;
+
+        write_varint(out, static_cast<std::uint64_t>(placement.tick - tick));
+        write_varint(out, placement.by_column);
+        write_varint(out, landing.index);
+        write_varint(out, zigzag(landing.position.row));
+        write_varint(out, zigzag(landing.position.column));
+        write_varint(out, static_cast<std::uint64_t>(landing.rotation));
+        tick = placement.tick;
+    }
+}
+
+Replay read_replay(std::istream& in)
+{
+    char header[sizeof(magic)] = {};
+
+    if (not in.read(header, sizeof(header)) or
+        not std::equal(std::begin(header), std::end(header), magic)) {
+        throw ReplayError{"Not a replay."};
+    }
+
+    auto replay = Replay{};
+    replay.version =
+        read_bounded<std::uint32_t>(in, UINT32_MAX, "Bad replay version.");
+    replay.seed = read_varint(in);
+    replay.randomizer = read_bounded<Randomizer>(
+        in,
+        static_cast<std::uint64_t>(Randomizer::Bag),
+        "Bad replay randomizer.");
+    replay.stream = read_varint(in);
+
+    auto run_count = read_varint(in);
+
+    for (auto i = std::uint64_t{0}; i < run_count; ++i) {
+        auto input = read_bounded<Input>(
+            in,
+            static_cast<std::uint64_t>(Input::HardDrop),
+            "Bad replay input.");
+        auto length = read_bounded<std::uint32_t>(
+            in,
+            UINT32_MAX,
+            "Bad replay run length.");
+
+        replay.runs.push_back({input, length});
+    }
+
+    auto placement_count = read_varint(in);
+    auto ticks = replay.ticks();
+    auto tick = std::int64_t{0};
+
+    for (auto i = std::uint64_t{0}; i < placement_count; ++i) {
+        tick += read_bounded<std::int64_t>(
+            in,
+            static_cast<std::uint64_t>(ticks - tick),
+            "Replay has placements past its end.");
+
+        auto by_column = read_bounded<bool>(in, 1, "Bad replay placement.");
+        auto index = read_bounded<std::size_t>(
+            in,
+            tetriminoes.size() - 1,
+            "Bad replay tetrimino.");
+        auto row = read_bounded<std::uint32_t>(
+            in,
+            UINT32_MAX,
+            "Bad replay placement row.");
+        auto column = read_bounded<std::uint32_t>(
+            in,
+            UINT32_MAX,
+            "Bad replay placement column.");
+
+        auto landing = FallingTetrimino{tetriminoes[index]};
+        landing.position.row = static_cast<int>(unzigzag(row));
+        landing.position.column = static_cast<int>(unzigzag(column));
+        landing.rotation = read_bounded<geom::Rotation>(
+            in,
+            static_cast<std::uint64_t>(geom::Rotation::R270),
+            "Bad replay rotation.");
+
+        replay.placements.push_back({tick, by_column, landing});
+    }
+
+    return replay;
+}
+
+void Recorder::record(Input input)
+{
+    auto& runs = replay_.runs;
+
+    if (not runs.empty() and runs.back().input == input and
+        runs.back().length < UINT32_MAX) {
+        ++runs.back().length;
+    } else {
+        runs.push_back({input, 1});
+    }
+
+    ++ticks_;
+}
+
+bool Recorder::place(Tetris& game, int column, geom::Rotation rotation)
+{
+    auto landing = game.falling_tetrimino();
+    landing.position.column = column;
+    landing.rotation = rotation;
+
+    replay_.placements.push_back({ticks_, true, landing});
+    return game.place(column, rotation);
+}
+
+bool Recorder::place(Tetris& game, FallingTetrimino const& landing)
+{
+    replay_.placements.push_back({ticks_, false, landing});
+    return game.place(landing);
+}
+
+Player::Player(Replay replay, std::int64_t keyframe_interval):
+    replay_{std::move(replay)},
+    keyframe_interval_{std::max<std::int64_t>(keyframe_interval, 1)},
+    current_{Tetris{replay_.rng()}, 0, 0, 0, 0}
+{
+    if (replay_.version != engine_version) {
+        throw ReplayError{"Replay was recorded by another engine version."};
+    }
+
+    // Drop empty runs so that `done` and `step` never see one.
+    replay_.runs.erase(
+        std::remove_if(
+            replay_.runs.begin(),
+            replay_.runs.end(),
+            [](InputRun const& run) { return run.length == 0; }),
+        replay_.runs.end());
+
+    auto const& placements = replay_.placements;
+
+    if (not std::is_sorted(
+            placements.begin(),
+            placements.end(),
+            [](Placement const& a, Placement const& b)
+            { return a.tick < b.tick; })) {
+        throw ReplayError{"Replay has placements out of order."};
+    }
+
+    if (not placements.empty() and
+        (placements.front().tick < 0 or
+         placements.back().tick > replay_.ticks())) {
+        throw ReplayError{"Replay has placements past its end."};
+    }
+
+    play_placements();
+    keyframes_.push_back(current_);
+}
+
+void Player::step()
+{
+    if (done()) {
+        return;
+    }
+
+    auto const& run = replay_.runs[current_.run];
+
+    current_.game.advance(run.input);
+    ++current_.tick;
+
+    if (++current_.offset == run.length) {
+        ++current_.run;
+        current_.offset = 0;
+    }
+
+    play_placements();
+
+    auto keyframe = current_.tick / keyframe_interval_;
+
+    if (current_.tick % keyframe_interval_ == 0 and
+        static_cast<std::size_t>(keyframe) == keyframes_.size()) {
+        keyframes_.push_back(current_);
+    }
+}
+
+void Player::seek(std::int64_t tick)
+{
+    tick = std::clamp<std::int64_t>(tick, 0, replay_.ticks());
+
+    // Keyframes only go as far as ticks played so far.
+    auto const& keyframe = keyframes_[std::min(
+        static_cast<std::size_t>(tick / keyframe_interval_),
+        keyframes_.size() - 1)];
+
+    if (tick < current_.tick or keyframe.tick > current_.tick) {
+        current_ = keyframe;
+    }
+
+    while (current_.tick < tick) {
+        step();
+    }
+}
+
+// Play the placements made after the current tick.
+void Player::play_placements()
+{
+    auto const& placements = replay_.placements;
+
+    while (current_.placement < placements.size() and
+           placements[current_.placement].tick == current_.tick) {
+        auto const& placement = placements[current_.placement++];
+        auto const& landing = placement.landing;
+
+        if (placement.by_column) {
+            current_.game.place(landing.position.column, landing.rotation);
+        } else {
+            current_.game.place(landing);
+        }
+    }
+}
+
+}
@@ -0,0 +1,213 @@
+#ifndef TETRIS_REPLAY_HPP
+#define TETRIS_REPLAY_HPP
+
+#include <cstdint>
+#include <iosfwd>
+#include <stdexcept>
+#include <vector>
+
+#include "tetris.hpp"
+
+// Recording and playback of games.
+//
+// A game is fully determined by its seed, the input given on each tick and
+// the placements made between ticks, so that is all a replay stores. Inputs
+// are run-length encoded, since most ticks are `Input::Nothing`.
+//
+// Binary layout, all integers being unsigned LEB128 varints:
+//
+//     "TRPL" magic
+//     engine version
+//     seed
+//     randomizer (as its enum value)
+//     stream
+//     number of runs
+//     runs, each an input (as its enum value) followed by the run length
+//     number of placements
+//     placements, each:
+//         ticks since the previous placement, or since the start
+//         1 for `place(column, rotation)`, 0 for `place(landing)`
+//         tetrimino index
+//         row and column, zigzag-encoded
+//         rotation (as its enum value)
+
+namespace tetris {
+
+// Signals a malformed or incompatible replay.
+struct ReplayError: std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+// The same input repeated over consecutive ticks.
+struct InputRun {
+    Input input;
+    std::uint32_t length;
+};
+
+// A call to `Tetris::place`, made between two ticks.
+struct Placement {
+    // Ticks played before it.
+    std::int64_t tick;
+
+    // Whether it was `place(column, rotation)`, which only uses the column
+    // and rotation of `landing`, rather than `place(landing)`.
+    bool by_column;
+
+    FallingTetrimino landing;
+};
+
+struct Replay {
+    std::uint32_t version = engine_version;
+    Rng::Seed seed = 0;
+    Randomizer randomizer = Randomizer::Uniform;
+    std::uint64_t stream = 0;
+    std::vector<InputRun> runs;
+
+    // In the order they were made, so by increasing `tick`.
+    std::vector<Placement> placements;
+
+    // The random number generator the game started with.
+    Rng rng() const
+    {
+        return Rng{seed, randomizer, stream};
+    }
+
+    // How many ticks the replay lasts.
+    std::int64_t ticks() const;
+};
+
+// Serialize a replay in the binary format.
+void write_replay(std::ostream& out, Replay const& replay);
+
+// Deserialize a replay in the binary format.
+//
+// Throws:
+//     ReplayError: If the data is truncated or malformed.
+Replay read_replay(std::istream& in);
+
+// Records the inputs and placements of a game as it is played.
+//
+// Only what goes through the recorder is recorded: calling `Tetris::advance`
+// or `Tetris::place` on the game directly makes its replay diverge.
+class Recorder {
+public:
+    // Args:
+    //     seed, randomizer, stream: What the game's `Rng` was built with.
+    explicit Recorder(
+        Rng::Seed seed,
+        Randomizer randomizer = Randomizer::Uniform,
+        std::uint64_t stream = 0)
+    {
+        replay_.seed = seed;
+        replay_.randomizer = randomizer;
+        replay_.stream = stream;
+    }
+
+    // Record the input for the next tick.
+    void record(Input input);
+
+    // Record an input and advance a game with it.
+    //
+    // Args:
+    //     game: The game being recorded, which must have been started with
+    //           the recorder's `Rng` settings.
+    //     input: The input for this tick.
+    void advance(Tetris& game, Input input)
+    {
+        record(input);
+        game.advance(input);
+    }
+
+    // Place a game's tetrimino and record the placement.
+    //
+    // Args:
+    //     game: The game being recorded.
+    //     column, rotation: As for `Tetris::place`.
+    //
+    // Returns:
+    //     Whether the tetrimino was placed.
+    bool place(Tetris& game, int column, geom::Rotation rotation);
+
+    // Place a game's tetrimino and record the placement.
+    //
+    // Args:
+    //     game: The game being recorded.
+    //     landing: As for `Tetris::place`.
+    //
+    // Returns:
+    //     Whether the tetrimino was placed.
+    bool place(Tetris& game, FallingTetrimino const& landing);
+
+    Replay const& replay() const
+    {
+        return replay_;
+    }
+
+private:
+    Replay replay_;
+    std::int64_t ticks_ = 0;
+};
+
+// Re-simulates a replay headlessly.
+//
+// Playing keeps a copy of the game every `keyframe_interval` ticks, the first
+// time it gets there. Seeking then restores the closest keyframe before the
+// target, so going back, or forward over ticks played before, costs at most
+// `keyframe_interval` ticks no matter how long the replay is.
+class Player {
+public:
+    // Args:
+    //     replay: The replay to play.
+    //     keyframe_interval: Ticks between keyframes.
+    //
+    // Throws:
+    //     ReplayError: If the replay was recorded by another engine version,
+    //                  or its placements are out of order or past its end.
+    explicit Player(Replay replay, std::int64_t keyframe_interval = 600);
+
+    // The game as of the current tick, including the placements made after
+    // it.
+    Tetris const& game() const
+    {
+        return current_.game;
+    }
+
+    // How many ticks have been played.
+    std::int64_t tick() const
+    {
+        return current_.tick;
+    }
+
+    bool done() const
+    {
+        return current_.run == replay_.runs.size();
+    }
+
+    // Play one tick, then the placements made after it. Does nothing once the
+    // replay is done.
+    void step();
+
+    // Move to a tick, which is clamped to the replay's length.
+    void seek(std::int64_t tick);
+
+private:
+    // A game plus where it is in the replay.
+    struct Cursor {
+        Tetris game;
+        std::int64_t tick;
+        std::size_t run;
+        std::uint32_t offset;
+        std::size_t placement;
+    };
+
+    void play_placements();
+
+    Replay replay_;
+    std::int64_t keyframe_interval_;
+    std::vector<Cursor> keyframes_;
+    Cursor current_;
+};
+
+}
+
+#endif
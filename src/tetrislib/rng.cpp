@@ -0,0 +1,28 @@
+#include "rng.hpp"
+
+namespace tetris {
+
+// First outputs of the reference `pcg32-demo` (seed 42, sequence 54).
+static_assert(
+    [] {
+        auto engine = Pcg32{42, 54};
+        return engine() == 0xa15c02b7 and engine() == 0x7b47f409 and
+               engine() == 0xba1d3330;
+    }(),
+    "Pcg32 must match the reference implementation.");
+
+static_assert(
+    [] {
+        auto skipped = Pcg32{42, 54};
+        auto stepped = skipped;
+        skipped.advance(1000);
+
+        for (auto i = 0; i < 1000; ++i) {
+            stepped();
+        }
+
+        return skipped() == stepped();
+    }(),
+    "Pcg32::advance must match stepping.");
+
+}
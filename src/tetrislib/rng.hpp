@@ -0,0 +1,184 @@
+#ifndef TETRIS_RNG_HPP
+#define TETRIS_RNG_HPP
+
+#include <array>
+#include <cstdint>
+
+namespace tetris {
+
+// PCG32 random number generator (PCG-XSH-RR with 64-bit state), as published
+// at https://www.pcg-random.org.
+//
+// Output is bit-exact on every platform: seeding follows `pcg32_srandom_r`
+// and each draw follows `pcg32_random_r` from the reference implementation.
+class Pcg32 {
+public:
+    using result_type = std::uint32_t;
+
+    // Args:
+    //     seed: Starting state.
+    //     sequence: Selects one of 2^63 distinct sequences.
+    constexpr explicit Pcg32(std::uint64_t seed, std::uint64_t sequence = 0):
+        increment_{(sequence << 1u) | 1u}
+    {
+        (*this)();
+        state_ += seed;
+        (*this)();
+    }
+
+    constexpr result_type operator()()
+    {
+        auto old = state_;
+        state_ = old * multiplier + increment_;
+
+        auto xorshifted =
+            static_cast<std::uint32_t>(((old >> 18u) ^ old) >> 27u);
+        auto rotation = static_cast<std::uint32_t>(old >> 59u);
+
+        return (xorshifted >> rotation) |
+               (xorshifted << ((32u - rotation) & 31u));
+    }
+
+    // Skip `delta` draws in O(log(delta)) time.
+    constexpr void advance(std::uint64_t delta)
+    {
+        // Brown, "Random Number Generation with Arbitrary Stride": compose
+        // the affine step with itself by repeated squaring.
+        auto total_multiplier = std::uint64_t{1};
+        auto total_increment = std::uint64_t{0};
+        auto step_multiplier = multiplier;
+        auto step_increment = increment_;
+
+        for (; delta > 0; delta >>= 1u) {
+            if (delta & 1u) {
+                total_multiplier *= step_multiplier;
+                total_increment =
+                    total_increment * step_multiplier + step_increment;
+            }
+
+            step_increment = (step_multiplier + 1) * step_increment;
+            step_multiplier *= step_multiplier;
+        }
+
+        state_ = total_multiplier * state_ + total_increment;
+    }
+
+    constexpr static result_type min()
+    {
+        return 0;
+    }
+
+    constexpr static result_type max()
+    {
+        return UINT32_MAX;
+    }
+
+private:
+    constexpr static auto multiplier = std::uint64_t{6364136223846793005u};
+
+    std::uint64_t state_ = 0;
+    std::uint64_t increment_;
+};
+
+// Uniform value in [0, bound), by rejection sampling as in
+// `pcg32_boundedrand_r`. Exact on every platform, unlike the standard
+// distributions.
+//
+// Args:
+//     engine: A generator with PCG32's uniform 32-bit `operator()`.
+//     bound: One past the largest value. Must not be zero.
+template <typename Engine>
+constexpr std::uint32_t bounded_rand(Engine& engine, std::uint32_t bound)
+{
+    auto threshold = (0u - bound) % bound;
+
+    while (true) {
+        auto value = engine();
+
+        if (value >= threshold) {
+            return value % bound;
+        }
+    }
+}
+
+// How tetriminoes are drawn.
+enum class Randomizer : std::uint8_t {
+    // Each tetrimino is independent from the previous ones.
+    Uniform,
+    // Tetriminoes are dealt from a shuffled bag of all seven, which is
+    // refilled once empty.
+    Bag,
+};
+
+// Source of tetrimino indices for a game.
+//
+// `Engine` may be any generator with PCG32's interface: a uniform 32-bit
+// `operator()`, `advance` to skip draws and a (seed, sequence) constructor.
+template <typename Engine> class BasicRng {
+public:
+    using Seed = std::uint64_t;
+
+    // Draws between the starts of consecutive streams.
+    constexpr static auto stream_length = std::uint64_t{1} << 48u;
+
+    // Args:
+    //     seed: Seed for the engine.
+    //     randomizer: How tetriminoes are drawn.
+    //     stream: Jumps `stream * stream_length` draws ahead, so that games
+    //             with the same seed and different streams (up to 2^16 of
+    //             them) never share draws.
+    constexpr explicit BasicRng(
+        Seed seed,
+        Randomizer randomizer = Randomizer::Uniform,
+        std::uint64_t stream = 0):
+        engine_{seed},
+        randomizer_{randomizer}
+    {
+        engine_.advance(stream * stream_length);
+    }
+
+    // Index of the next tetrimino, in [0, 7).
+    constexpr int get_int()
+    {
+        if (randomizer_ == Randomizer::Uniform) {
+            return static_cast<int>(bounded_rand(engine_, kinds));
+        }
+
+        if (bag_left_ == 0) {
+            refill_bag();
+        }
+
+        return bag_[--bag_left_];
+    }
+
+private:
+    constexpr static auto kinds = std::uint32_t{7};
+
+    // Fisher-Yates shuffle of all kinds, dealt from the back.
+    constexpr void refill_bag()
+    {
+        for (auto i = std::uint32_t{0}; i < kinds; ++i) {
+            bag_[i] = static_cast<std::uint8_t>(i);
+        }
+
+        for (auto i = kinds - 1; i > 0; --i) {
+            auto j = bounded_rand(engine_, i + 1);
+            auto swapped = bag_[i];
+            bag_[i] = bag_[j];
+            bag_[j] = swapped;
+        }
+
+        bag_left_ = static_cast<std::uint8_t>(kinds);
+    }
+
+    Engine engine_;
+    Randomizer randomizer_;
+    std::uint8_t bag_left_ = 0;
+    std::array<std::uint8_t, kinds> bag_{};
+};
+
+using Rng = BasicRng<Pcg32>;
+
+}
+
+#endif
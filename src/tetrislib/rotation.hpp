@@ -0,0 +1,166 @@
+#ifndef TETRIS_ROTATION_HPP
+#define TETRIS_ROTATION_HPP
+
+#include <array>
+#include <cstddef>
+
+#include "matrix.hpp"
+#include "tetriminoes.hpp"
+
+// Rotation systems: where a tetrimino ends up when it rotates.
+//
+// A tetrimino's layouts are its 4x4 shape rotated about the shape's centre
+// (see `Tetrimino::layout`). A rotation system turns a rotation into a short
+// list of position offsets to try, in order, the first offset at which the
+// rotated layout fits winning. Offsets fold in both the system's own pivot
+// and its wall kicks, so a rotation costs one `Board::piece_fits` mask check
+// per offset tried and nothing else.
+//
+// A rotation system provides:
+//     kicks(tetrimino, from): The offsets of a clockwise rotation from
+//                             `from`, for the tetrimino at that index in
+//                             `tetriminoes`.
+
+namespace tetris {
+
+// Position offsets to try, in order, when rotating a tetrimino.
+struct Kicks {
+    std::array<geom::Position, 5> offsets;
+    int size;
+};
+
+// Rotation about the centre of the 4x4 shape, with no kicks: a rotated
+// tetrimino that doesn't fit where it is doesn't rotate.
+struct MatrixRotation {
+    constexpr static Kicks const&
+    kicks(std::size_t /* tetrimino */, geom::Rotation /* from */)
+    {
+        return no_kicks;
+    }
+
+    constexpr static auto no_kicks = Kicks{{{{0, 0}}}, 1};
+};
+
+namespace srs {
+
+// Rotation states in SRS order: spawn, right, 180 and left, i.e. clockwise.
+constexpr auto states = 4;
+
+// SRS wall kicks of clockwise rotations, indexed by the state rotated from.
+// Offsets are (row, column) with rows growing downwards, where the SRS tables
+// are usually written as (x, y) with y growing upwards.
+using KickTable = std::array<std::array<geom::Position, 5>, states>;
+
+constexpr auto jlstz_kicks = KickTable{{
+    {{{0, 0}, {0, -1}, {-1, -1}, {2, 0}, {2, -1}}},
+    {{{0, 0}, {0, 1}, {1, 1}, {-2, 0}, {-2, 1}}},
+    {{{0, 0}, {0, 1}, {-1, 1}, {2, 0}, {2, 1}}},
+    {{{0, 0}, {0, -1}, {1, -1}, {-2, 0}, {-2, -1}}},
+}};
+
+constexpr auto i_kicks = KickTable{{
+    {{{0, 0}, {0, -2}, {0, 1}, {1, -2}, {-2, 1}}},
+    {{{0, 0}, {0, -1}, {0, 2}, {-2, -1}, {1, 2}}},
+    {{{0, 0}, {0, 2}, {0, -1}, {-1, 2}, {2, -1}}},
+    {{{0, 0}, {0, 1}, {0, -2}, {2, 1}, {-1, -2}}},
+}};
+
+// The box a tetrimino rotates in under SRS, within its 4x4 shape.
+struct Box {
+    geom::Position origin;
+    int size;
+};
+
+constexpr Box box_of(BlockType type)
+{
+    switch (type) {
+        case BlockType::I: {
+            return {{0, 0}, 4};
+        }
+        case BlockType::O: {
+            return {{0, 1}, 2};
+        }
+        default: {
+            return {{0, 0}, 3};
+        }
+    }
+}
+
+// How far SRS's rotation of a box puts a tetrimino from where rotating the
+// whole 4x4 shape does, after `turns` clockwise turns. Both rotations only
+// differ by a translation, so following any one point is enough.
+constexpr geom::Position pivot_shift(Box box, int turns)
+{
+    auto in_box = geom::Position{0, 0};
+    auto in_shape = geom::Position{0, 0};
+
+    for (auto turn = 0; turn < turns; ++turn) {
+        in_box = {
+            box.origin.row + in_box.column - box.origin.column,
+            box.origin.column + box.size - 1 - (in_box.row - box.origin.row),
+        };
+        in_shape = {in_shape.column, 3 - in_shape.row};
+    }
+
+    return {in_box.row - in_shape.row, in_box.column - in_shape.column};
+}
+
+constexpr Kicks make_kicks(BlockType type, int from)
+{
+    auto box = box_of(type);
+    auto from_shift = pivot_shift(box, from);
+    auto to_shift = pivot_shift(box, (from + 1) % states);
+    auto pivot = geom::Position{
+        to_shift.row - from_shift.row,
+        to_shift.column - from_shift.column,
+    };
+
+    if (type == BlockType::O) {
+        return {{{pivot}}, 1};
+    }
+
+    auto const& table = type == BlockType::I ? i_kicks : jlstz_kicks;
+    auto kicks = Kicks{{}, 5};
+
+    for (auto i = std::size_t{0}; i < kicks.offsets.size(); ++i) {
+        auto const& kick = table[static_cast<std::size_t>(from)][i];
+        kicks.offsets[i] = {pivot.row + kick.row, pivot.column + kick.column};
+    }
+
+    return kicks;
+}
+
+using KickTables = std::array<std::array<Kicks, states>, tetriminoes.size()>;
+
+constexpr KickTables make_kick_tables()
+{
+    auto tables = KickTables{};
+
+    for (auto t = std::size_t{0}; t < tetriminoes.size(); ++t) {
+        for (auto from = 0; from < states; ++from) {
+            tables[t][static_cast<std::size_t>(from)] =
+                make_kicks(tetriminoes[t].type(), from);
+        }
+    }
+
+    return tables;
+}
+
+inline constexpr auto kick_tables = make_kick_tables();
+
+}
+
+// The Super Rotation System of modern games: tetriminoes rotate within their
+// bounding box, I and O about its centre, and try four wall kicks when the
+// plain rotation doesn't fit.
+struct SrsRotation {
+    constexpr static Kicks const&
+    kicks(std::size_t tetrimino, geom::Rotation from)
+    {
+        return srs::kick_tables[tetrimino][static_cast<std::size_t>(from)];
+    }
+};
+
+}
+
+#endif
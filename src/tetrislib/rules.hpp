@@ -0,0 +1,110 @@
+#ifndef TETRIS_RULES_HPP
+#define TETRIS_RULES_HPP
+
+#include <algorithm>
+#include <iterator>
+
+#include "rotation.hpp"
+
+namespace tetris {
+
+// Rules fix a game's board size and timings at compile time, so each variant
+// gets its own fully specialised board and game logic.
+//
+// A rules type provides:
+//     rows, columns: Board size. Up to 63 rows and 10 columns.
+//     clear_delay: Ticks full lines stay on the board before being removed.
+//     lock_delay: Ticks a tetrimino that can't fall any further waits before
+//                 locking, on top of the usual wait between drops.
+//     lock_resets: How many times moving or rotating a tetrimino during its
+//                  lock delay restarts the delay. 0 disables resets.
+//     hard_drop: Whether `Input::HardDrop` drops and locks the tetrimino at
+//                once. Otherwise it does nothing.
+//     soft_drop_rows: Rows `Input::Down` moves the tetrimino, stopping where
+//                     it lands.
+//     das, arr: Auto-repeat of a held `Input::Left` or `Input::Right`, i.e.
+//               one given on consecutive ticks. The first tick moves, then
+//               the tetrimino stays put until it was held `das` ticks and
+//               then moves every `arr` ticks, or all the way if `arr` is 0.
+//               A `das` of 0 disables auto-repeat: every tick moves.
+//     ticks_to_fall(lines): Ticks between drops, once `lines` lines have
+//                           been cleared.
+//     rotation_system: How tetriminoes rotate, see `rotation.hpp`.
+//
+// Disabled features cost nothing: the game logic skips them at compile time.
+//
+// Boards and game logic are compiled for the rules instantiated at the end of
+// `board.cpp` and `tetris.cpp`; new rules have to be added there.
+
+// The original game.
+struct StandardRules {
+    constexpr static auto rows = 20;
+    constexpr static auto columns = 10;
+    constexpr static auto clear_delay = 20;
+    constexpr static auto lock_delay = 0;
+    constexpr static auto lock_resets = 0;
+    constexpr static auto hard_drop = false;
+    constexpr static auto soft_drop_rows = 1;
+    constexpr static auto das = 0;
+    constexpr static auto arr = 0;
+
+    using rotation_system = SrsRotation;
+
+    constexpr static int ticks_to_fall(int /* lines */)
+    {
+        return 20;
+    }
+};
+
+// A board twice as tall, like modern games with room above the visible
+// playfield.
+struct TallRules: StandardRules {
+    constexpr static auto rows = 40;
+};
+
+// A small, fast board for training agents: short games and small
+// observations.
+struct CompactRules: StandardRules {
+    constexpr static auto rows = 12;
+    constexpr static auto columns = 6;
+    constexpr static auto clear_delay = 0;
+
+    // Speed up by a tick every 10 lines, down to a drop every 4 ticks.
+    constexpr static int ticks_to_fall(int lines)
+    {
+        return lines < 160 ? 20 - lines / 10 : 4;
+    }
+};
+
+// Timings of modern games: hard drop, a lock delay that moves can extend a
+// few times, auto-repeat and gravity that speeds up every 10 lines.
+struct ModernRules: StandardRules {
+    constexpr static auto lock_delay = 30;
+    constexpr static auto lock_resets = 15;
+    constexpr static auto hard_drop = true;
+    constexpr static auto soft_drop_rows = 2;
+    constexpr static auto das = 10;
+    constexpr static auto arr = 2;
+
+    // Ticks per drop of each level, the level being `lines / 10`. Levels past
+    // the last one keep its speed.
+    constexpr static int ticks_to_fall(int lines)
+    {
+        constexpr int curve[] = {48, 43, 38, 33, 28, 23, 18, 13, 8, 6,
+                                 5,  5,  5,  4,  4,  4,  3,  3,  3, 2,
+                                 2,  2,  2,  2,  2,  2,  2,  2,  2, 1};
+        constexpr auto levels = static_cast<int>(std::size(curve));
+
+        return curve[std::min(lines / 10, levels - 1)];
+    }
+};
+
+// The tallest board whose row sets fit in 32 bits, compiled so that the tests
+// cover the switch to 64-bit row sets.
+struct Rows32Rules: StandardRules {
+    constexpr static auto rows = 32;
+};
+
+}
+
+#endif
@@ -1,13 +1,28 @@
 #ifndef TETRIS_TETRIMINOES_HPP
 #define TETRIS_TETRIMINOES_HPP
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
 
 #include "block_type.hpp"
 #include "matrix.hpp"
 
 namespace tetris {
 
+// Where a tetrimino's blocks are for one of its rotations.
+struct PieceLayout {
+    // Positions of the solid blocks, relative to the shape's top-left corner.
+    std::array<geom::Position, 4> blocks;
+
+    // Bounding box of the solid blocks, both corners inclusive.
+    geom::Position min, max;
+
+    // The solid blocks as row masks, one per 16-bit lane, starting at row
+    // `min.row`. Bit `c` of a lane stands for column `c` of the shape.
+    std::uint64_t row_masks;
+};
+
 // Represent a tetrimino (a tetris piece).
 class Tetrimino {
 public:
@@ -16,7 +31,9 @@ public:
     // Build a tetrimino representation with its shape.
     // Args:
     //     shape: A 4x4 boolean matrix representing the shape of the piece.
-    constexpr Tetrimino(Shape shape, BlockType type): shape_{shape}, type_{type}
+    //            Must have exactly four solid blocks.
+    constexpr Tetrimino(Shape shape, BlockType type):
+        shape_{shape}, type_{type}, layouts_{make_layouts(shape)}
     {}
 
     const Shape& shape() const
@@ -24,25 +41,73 @@ public:
         return shape_;
     }
 
-    BlockType type() const
+    constexpr BlockType type() const
     {
         return type_;
     }
 
+    // Precomputed layout of the tetrimino for a rotation.
+    constexpr PieceLayout const& layout(geom::Rotation rotation) const
+    {
+        return layouts_[static_cast<std::size_t>(rotation)];
+    }
+
 private:
+    using Layouts = std::array<PieceLayout, 4>;
+
+    constexpr static PieceLayout
+    make_layout(Shape const& shape, geom::Rotation rotation)
+    {
+        auto layout = PieceLayout{{}, {4, 4}, {-1, -1}, 0};
+        auto block = std::size_t{0};
+
+        for (auto row = 0; row < 4; ++row) {
+            for (auto column = 0; column < 4; ++column) {
+                if (shape[{{row, column}, rotation}]) {
+                    layout.blocks[block++] = {row, column};
+                    layout.min.row = std::min(layout.min.row, row);
+                    layout.min.column = std::min(layout.min.column, column);
+                    layout.max.row = std::max(layout.max.row, row);
+                    layout.max.column = std::max(layout.max.column, column);
+                }
+            }
+        }
+
+        for (auto const& position: layout.blocks) {
+            auto lane = position.row - layout.min.row;
+            layout.row_masks |= std::uint64_t{1}
+                                << (16 * lane + position.column);
+        }
+
+        return layout;
+    }
+
+    constexpr static Layouts make_layouts(Shape const& shape)
+    {
+        return {
+            make_layout(shape, geom::Rotation::R0),
+            make_layout(shape, geom::Rotation::R90),
+            make_layout(shape, geom::Rotation::R180),
+            make_layout(shape, geom::Rotation::R270),
+        };
+    }
+
     Shape shape_;
     BlockType type_;
+    Layouts layouts_;
 };
 
-// Tetriminoes "assets".
-constexpr auto tetriminoes = std::array<Tetrimino, 7>{
+// Tetriminoes "assets", in their spawn orientation. The JLSTZ shapes sit in
+// the top-left 3x3 corner and O in the middle of the top two rows, where the
+// SRS rotation system expects them (see `rotation.hpp`).
+inline constexpr auto tetriminoes = std::array<Tetrimino, 7>{
     Tetrimino{
         {{
             // clang-format off
-            0, 0, 1, 0,
-            0, 0, 1, 0,
-            0, 0, 1, 0,
-            0, 0, 1, 0,
+            0, 0, 0, 0,
+            1, 1, 1, 1,
+            0, 0, 0, 0,
+            0, 0, 0, 0,
             // clang-format on
         }},
         BlockType::I,
@@ -50,9 +115,9 @@ constexpr auto tetriminoes = std::array<Tetrimino, 7>{
     {
         {{
             // clang-format off
-            0, 0, 1, 0,
+            1, 1, 0, 0,
             0, 1, 1, 0,
-            0, 1, 0, 0,
+            0, 0, 0, 0,
             0, 0, 0, 0,
             // clang-format on
         }},
@@ -61,9 +126,9 @@ constexpr auto tetriminoes = std::array<Tetrimino, 7>{
     {
         {{
             // clang-format off
-            0, 1, 0, 0,
             0, 1, 1, 0,
-            0, 0, 1, 0,
+            1, 1, 0, 0,
+            0, 0, 0, 0,
             0, 0, 0, 0,
             // clang-format on
         }},
@@ -72,10 +137,10 @@ constexpr auto tetriminoes = std::array<Tetrimino, 7>{
     {
         {{
             // clang-format off
-            0, 0, 0, 0,
             0, 1, 1, 0,
             0, 1, 1, 0,
             0, 0, 0, 0,
+            0, 0, 0, 0,
             // clang-format on
         }},
         BlockType::O,
@@ -83,9 +148,9 @@ constexpr auto tetriminoes = std::array<Tetrimino, 7>{
     {
         {{
             // clang-format off
-            0, 0, 1, 0,
-            0, 1, 1, 0,
-            0, 0, 1, 0,
+            0, 1, 0, 0,
+            1, 1, 1, 0,
+            0, 0, 0, 0,
             0, 0, 0, 0,
             // clang-format on
         }},
@@ -94,9 +159,9 @@ constexpr auto tetriminoes = std::array<Tetrimino, 7>{
     {
         {{
             // clang-format off
-            0, 0, 1, 0,
-            0, 0, 1, 0,
-            0, 1, 1, 0,
+            1, 0, 0, 0,
+            1, 1, 1, 0,
+            0, 0, 0, 0,
             0, 0, 0, 0,
             // clang-format on
         }},
@@ -105,9 +170,9 @@ constexpr auto tetriminoes = std::array<Tetrimino, 7>{
     {
         {{
             // clang-format off
-            0, 1, 0, 0,
-            0, 1, 0, 0,
-            0, 1, 1, 0,
+            0, 0, 1, 0,
+            1, 1, 1, 0,
+            0, 0, 0, 0,
             0, 0, 0, 0,
             // clang-format on
         }},
@@ -115,6 +180,12 @@ constexpr auto tetriminoes = std::array<Tetrimino, 7>{
     },
 };
 
+// Position of a tetrimino in `tetriminoes`.
+inline std::size_t index_of(Tetrimino const& tetrimino)
+{
+    return static_cast<std::size_t>(&tetrimino - tetriminoes.data());
+}
+
 }
 
 #endif
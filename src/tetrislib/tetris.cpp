@@ -1,8 +1,8 @@
 #include "tetris.hpp"
 
-#include <vector>
-
-#include "containers.hpp"
+#include <bitset>
+#include <optional>
+#include <type_traits>
 
 namespace {
 
@@ -15,19 +15,41 @@ geom::Rotation next(geom::Rotation rot)
 
 namespace tetris {
 
-void Tetris::apply_input(Input input)
+// Game state lives entirely inline: copying it, or ticking it, never touches
+// the heap.
+static_assert(
+    std::is_trivially_copyable_v<GameState>,
+    "Game state must be copyable with memcpy.");
+static_assert(
+    std::is_trivially_copyable_v<Snapshot>,
+    "Snapshots must be copyable with memcpy.");
+
+template <typename Rules>
+bool try_move(
+    BasicBoard<Rules> const& board,
+    FallingTetrimino& falling,
+    Input input)
 {
-    auto maybe_new_rotation = [&]() -> std::optional<geom::Rotation>
-    {
-        switch (input) {
-            case Input::Rotate: {
-                return next(state.falling.rotation);
-            }
-            default: {
-                return std::nullopt;
+    auto const& tetrimino = falling.tetrimino();
+
+    if (input == Input::Rotate) {
+        auto const& kicks =
+            Rules::rotation_system::kicks(falling.index, falling.rotation);
+        auto new_rotation = next(falling.rotation);
+
+        for (auto i = 0; i < kicks.size; ++i) {
+            auto new_position =
+                falling.position + kicks.offsets[static_cast<std::size_t>(i)];
+
+            if (board.piece_fits(tetrimino, new_position, new_rotation)) {
+                falling.position = new_position;
+                falling.rotation = new_rotation;
+                return true;
             }
         }
-    }();
+
+        return false;
+    }
 
     auto maybe_movement = [&]() -> std::optional<geom::Position>
     {
@@ -47,35 +69,103 @@ void Tetris::apply_input(Input input)
         }
     }();
 
-    if (maybe_movement or maybe_new_rotation) {
-        auto new_position = state.falling.position +
-                            maybe_movement.value_or(geom::Position{0, 0});
-        auto new_rotation = maybe_new_rotation.value_or(state.falling.rotation);
-
-        if (board_.piece_fits(
-                state.falling.tetrimino,
-                new_position,
-                new_rotation)) {
-            state.falling.position = new_position;
-            state.falling.rotation = new_rotation;
+    if (maybe_movement) {
+        auto new_position = falling.position + *maybe_movement;
+
+        if (board.piece_fits(tetrimino, new_position, falling.rotation)) {
+            falling.position = new_position;
+            return true;
         }
     }
+
+    return false;
 }
 
-void Tetris::check_for_game_over()
+template <typename Rules>
+void BasicGameView<Rules>::apply_input(Input input)
+{
+    auto moved = false;
+
+    if constexpr (Rules::das > 0) {
+        if (not auto_repeat_allows(input)) {
+            return;
+        }
+
+        if constexpr (Rules::arr == 0) {
+            auto sliding = (input == Input::Left or input == Input::Right) and
+                           state.held_ticks >= Rules::das;
+
+            while (sliding and try_move(board_, state.falling, input)) {
+                moved = true;
+            }
+        }
+    }
+
+    if constexpr (Rules::soft_drop_rows > 1) {
+        if (input == Input::Down) {
+            for (auto row = 1; row < Rules::soft_drop_rows; ++row) {
+                moved = try_move(board_, state.falling, input) or moved;
+            }
+        }
+    }
+
+    moved = try_move(board_, state.falling, input) or moved;
+
+    // Moving a tetrimino that waits to lock restarts the wait, a limited
+    // number of times per tetrimino.
+    if constexpr (Rules::lock_delay > 0 and Rules::lock_resets > 0) {
+        if (moved and state.lock_ticks > 0 and
+            state.lock_resets < Rules::lock_resets) {
+            state.lock_ticks = 0;
+            ++state.lock_resets;
+        }
+    }
+}
+
+template <typename Rules>
+bool BasicGameView<Rules>::auto_repeat_allows(Input input)
+{
+    if (input != Input::Left and input != Input::Right) {
+        state.held_input = Input::Nothing;
+        state.held_ticks = 0;
+        return true;
+    }
+
+    if (input != state.held_input) {
+        state.held_input = input;
+        state.held_ticks = 0;
+        return true;
+    }
+
+    ++state.held_ticks;
+
+    if (state.held_ticks < Rules::das) {
+        return false;
+    }
+
+    if constexpr (Rules::arr > 0) {
+        return (state.held_ticks - Rules::das) % Rules::arr == 0;
+    } else {
+        return true;
+    }
+}
+
+template <typename Rules>
+void BasicGameView<Rules>::check_for_game_over()
 {
     state.game_over = not board_.piece_fits(
-        state.falling.tetrimino,
+        state.falling.tetrimino(),
         state.falling.position,
         state.falling.rotation);
 }
 
-bool Tetris::try_drop()
+template <typename Rules>
+bool BasicGameView<Rules>::try_drop()
 {
     auto down = state.falling.position + geom::Position{1, 0};
 
     if (not board_.piece_fits(
-            state.falling.tetrimino,
+            state.falling.tetrimino(),
             down,
             state.falling.rotation)) {
         return false;
@@ -85,103 +175,207 @@ bool Tetris::try_drop()
     return true;
 }
 
-void Tetris::pick_new_tetrimino()
+template <typename Rules>
+void BasicGameView<Rules>::pick_new_tetrimino()
 {
     state.falling = FallingTetrimino{random_tetrimino(rng_)};
+    state.lock_ticks = 0;
+    state.lock_resets = 0;
 }
 
-void Tetris::lock_tetrimino()
+template <typename Rules>
+void BasicGameView<Rules>::lock_tetrimino()
 {
-    auto& tetrimino = state.falling.tetrimino.get();
+    board_.lock(
+        state.falling.tetrimino(),
+        state.falling.position,
+        state.falling.rotation);
+}
 
-    for (auto r = 0; r < 4; ++r) {
-        for (auto c = 0; c < 4; ++c) {
-            if (tetrimino.shape()[{{r, c}, state.falling.rotation}]) {
-                board_[state.falling.position + geom::Position{r, c}] =
-                    tetrimino.type();
-            }
-        }
+template <typename Rules>
+void BasicGameView<Rules>::settle()
+{
+    lock_tetrimino();
+    mark_cleared_lines();
+    pick_new_tetrimino();
+    check_for_game_over();
+}
+
+template <typename Rules>
+void BasicGameView<Rules>::mark_cleared_lines()
+{
+    state.cleared_lines = board_.full_rows();
+
+    if (state.cleared_lines) {
+        board_.fill_rows(state.cleared_lines, BlockType::Line);
+        state.clearing_ticks = Rules::clear_delay;
+        state.lines += static_cast<int>(
+            std::bitset<Rules::rows>{state.cleared_lines}.count());
     }
 }
 
-void Tetris::mark_cleared_lines()
+template <typename Rules>
+void BasicGameView<Rules>::clear_lines()
 {
-    for (auto r = 0; r < 4; ++r) {
-        auto row = r + state.falling.position.row;
+    board_.collapse_rows(state.cleared_lines);
+    state.cleared_lines = 0;
+}
 
-        auto full = [&]()
-        {
-            for (auto c = 0; c < board_.columns; ++c) {
-                if (board_[{row, c}] == BlockType::Empty) {
-                    return false;
-                }
-            }
+template <typename Rules>
+void BasicGameView<Rules>::finish_clearing()
+{
+    if (state.cleared_lines) {
+        state.clearing_ticks = 0;
+        clear_lines();
+    }
+}
 
-            return true;
-        }();
+template <typename Rules>
+void BasicGameView<Rules>::lock_at(FallingTetrimino const& landing)
+{
+    state.falling = landing;
 
-        if (full) {
-            state.cleared_lines.push_back(row);
-        }
+    lock_tetrimino();
+    mark_cleared_lines();
+    finish_clearing();
+    pick_new_tetrimino();
+    check_for_game_over();
+
+    state.ticks = 0;
+}
+
+template <typename Rules>
+bool BasicGameView<Rules>::place(int column, geom::Rotation rotation)
+{
+    if (state.game_over) {
+        return false;
     }
 
-    if (not state.cleared_lines.empty()) {
-        for (auto row: state.cleared_lines) {
-            for (auto c = 0; c < board_.columns; ++c) {
-                board_[{row, c}] = BlockType::Line;
-            }
+    finish_clearing();
+
+    auto landing = state.falling;
+    auto const& tetrimino = landing.tetrimino();
+
+    landing.rotation = rotation;
+
+    if (not board_.piece_fits(tetrimino, landing.position, rotation)) {
+        return false;
+    }
+
+    auto step = column < landing.position.column ? -1 : 1;
+
+    while (landing.position.column != column) {
+        landing.position.column += step;
+
+        if (not board_.piece_fits(tetrimino, landing.position, rotation)) {
+            return false;
         }
+    }
+
+    auto below = landing.position + geom::Position{1, 0};
 
-        state.clearing_ticks = state.ticks_to_fall;
+    while (board_.piece_fits(tetrimino, below, rotation)) {
+        landing.position = below;
+        below.row += 1;
     }
+
+    lock_at(landing);
+    return true;
 }
 
-void Tetris::clear_lines()
+template <typename Rules>
+bool BasicGameView<Rules>::place(FallingTetrimino const& landing)
 {
-    auto writing_row = board_.rows - 1;
+    if (state.game_over) {
+        return false;
+    }
 
-    for (auto row = writing_row; row >= 0; --row) {
-        if (util::contains(state.cleared_lines, row)) {
-            continue;
-        }
+    finish_clearing();
 
-        for (auto c = 0; c < board_.columns; ++c) {
-            board_[{writing_row, c}] = board_[{row, c}];
-        }
+    auto const& tetrimino = landing.tetrimino();
+    auto below = landing.position + geom::Position{1, 0};
 
-        --writing_row;
+    if (landing.index != state.falling.index or
+        not board_.piece_fits(tetrimino, landing.position, landing.rotation) or
+        board_.piece_fits(tetrimino, below, landing.rotation)) {
+        return false;
     }
 
-    state.cleared_lines.clear();
+    lock_at(landing);
+    return true;
 }
 
-State Tetris::game_tick(Input input)
+template <typename Rules>
+State BasicGameView<Rules>::game_tick(Input input)
 {
     if (state.clearing_ticks > 0) {
         --state.clearing_ticks;
         return State::Clearing;
     }
 
-    if (not state.cleared_lines.empty()) {
+    if (state.cleared_lines) {
         clear_lines();
     }
 
+    if constexpr (Rules::hard_drop) {
+        if (input == Input::HardDrop) {
+            while (try_drop()) {
+            }
+
+            settle();
+            return State::Dropped;
+        }
+    }
+
     apply_input(input);
 
-    if (state.ticks < state.ticks_to_fall) {
+    if (state.ticks < Rules::ticks_to_fall(state.lines)) {
         return State::Default;
     }
 
     if (try_drop()) {
+        state.lock_ticks = 0;
         return State::Dropped;
     }
 
-    lock_tetrimino();
-    mark_cleared_lines();
-    pick_new_tetrimino();
-    check_for_game_over();
+    // Keep trying to fall on every tick until the lock delay runs out, in
+    // case the tetrimino is moved off what it landed on.
+    if constexpr (Rules::lock_delay > 0) {
+        if (state.lock_ticks < Rules::lock_delay) {
+            ++state.lock_ticks;
+            return State::Default;
+        }
+    }
 
+    settle();
     return State::Dropped;
 }
 
+template bool try_move(
+    BasicBoard<StandardRules> const& board,
+    FallingTetrimino& falling,
+    Input input);
+template bool try_move(
+    BasicBoard<TallRules> const& board,
+    FallingTetrimino& falling,
+    Input input);
+template bool try_move(
+    BasicBoard<CompactRules> const& board,
+    FallingTetrimino& falling,
+    Input input);
+template bool try_move(
+    BasicBoard<ModernRules> const& board,
+    FallingTetrimino& falling,
+    Input input);
+template bool try_move(
+    BasicBoard<Rows32Rules> const& board,
+    FallingTetrimino& falling,
+    Input input);
+
+template class BasicGameView<StandardRules>;
+template class BasicGameView<TallRules>;
+template class BasicGameView<CompactRules>;
+template class BasicGameView<ModernRules>;
+template class BasicGameView<Rows32Rules>;
+
 }
@@ -1,56 +1,148 @@
 #ifndef TETRIS_TETRIS_HPP
 #define TETRIS_TETRIS_HPP
 
-#include <functional>
-#include <random>
-#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <optional>
 
 #include "board.hpp"
+#include "rng.hpp"
+#include "rules.hpp"
 #include "unreachable.hpp"
 
 namespace tetris {
 
-class Rng {
-public:
-    Rng(std::default_random_engine engine): engine_{std::move(engine)} {}
+// Version of the game rules. Bump it whenever a change makes the same seed and
+// inputs play out differently, so that old replays are rejected.
+constexpr auto engine_version = std::uint32_t{4};
+
+struct FallingTetrimino {
+    FallingTetrimino(Tetrimino const& t):
+        index{static_cast<std::uint8_t>(index_of(t))}
+    {}
 
-    int get_int()
+    Tetrimino const& tetrimino() const
     {
-        return distribution(engine_);
+        return tetriminoes[index];
     }
 
-private:
-    std::default_random_engine engine_;
-    std::uniform_int_distribution<int> distribution{0, 6};
-};
-
-struct FallingTetrimino {
-    FallingTetrimino(Tetrimino const& t): tetrimino{t} {}
-
-    std::reference_wrapper<Tetrimino const> tetrimino;
+    // Position in `tetriminoes`.
+    std::uint8_t index;
     geom::Position position{0, 0};
     geom::Rotation rotation{geom::Rotation::R0};
 };
 
-struct GameState {
-    GameState(FallingTetrimino t): falling(std::move(t)) {}
+// What a tick's input asks for.
+//
+// `HardDrop` comes after `Nothing`, so that inputs drawn from `Left` through
+// `Nothing` keep meaning the same thing.
+enum class Input {
+    Left,
+    Right,
+    Down,
+    Rotate,
+    Nothing,
+    HardDrop,
+};
+
+template <typename Rules> struct BasicGameState {
+    BasicGameState(FallingTetrimino t): falling(std::move(t)) {}
 
     FallingTetrimino falling;
     int clearing_ticks = 0;
-    int ticks_to_fall = 20;
     int ticks = 1;
+    // Ticks the falling tetrimino spent unable to fall, up to
+    // `Rules::lock_delay`.
+    int lock_ticks = 0;
+    // Times the falling tetrimino's lock delay was restarted, up to
+    // `Rules::lock_resets`.
+    int lock_resets = 0;
+    // The sideways input given on consecutive ticks so far, if any, and for
+    // how many ticks after the first, for `Rules::das`.
+    Input held_input = Input::Nothing;
+    int held_ticks = 0;
+    // Lines cleared so far.
+    int lines = 0;
     bool game_over = false;
-    std::vector<int> cleared_lines;
+
+    // Rows waiting to be removed once `clearing_ticks` runs out.
+    typename BasicBoard<Rules>::RowSet cleared_lines = 0;
 };
 
-enum class Input {
-    Left,
-    Right,
-    Down,
-    Rotate,
-    Nothing,
+using GameState = BasicGameState<StandardRules>;
+
+// How many `advance(Input::Nothing)` calls it takes for the board or the
+// falling tetrimino to change, counting the call that changes them.
+//
+// Until then, only counters move, so a frontend that has nothing to draw may
+// sleep this many ticks unless some input comes first.
+//
+// Returns:
+//     The tick count, or nothing once the game is over.
+template <typename Rules>
+std::optional<int> ticks_until_update(BasicGameState<Rules> const& state)
+{
+    if (state.game_over) {
+        return std::nullopt;
+    }
+
+    if (state.clearing_ticks > 0) {
+        return state.clearing_ticks + 1;
+    }
+
+    if (state.cleared_lines) {
+        return 1;
+    }
+
+    return std::max(Rules::ticks_to_fall(state.lines) - state.ticks + 1, 1);
+}
+
+// Board rows a falling tetrimino has blocks in.
+template <typename Rules>
+typename BasicBoard<Rules>::RowSet covered_rows(
+    FallingTetrimino const& falling)
+{
+    using RowSet = typename BasicBoard<Rules>::RowSet;
+
+    auto const& layout = falling.tetrimino().layout(falling.rotation);
+    auto first = falling.position.row + layout.min.row;
+    auto last = falling.position.row + layout.max.row;
+    auto covered = RowSet{0};
+
+    for (auto row = std::max(first, 0); row <= last and row < Rules::rows;
+         ++row) {
+        covered |= RowSet{1} << row;
+    }
+
+    return covered;
+}
+
+// Everything needed to restore a `Tetris` game.
+//
+// Trivially copyable and free of pointers, so copies are plain memcpys.
+template <typename Rules> struct BasicSnapshot {
+    BasicBoard<Rules> board;
+    Rng rng;
+    BasicGameState<Rules> state;
 };
 
+using Snapshot = BasicSnapshot<StandardRules>;
+
+// Move a falling tetrimino as an input asks, if it fits there.
+//
+// Args:
+//     board: The board the tetrimino is falling on.
+//     falling: The tetrimino, which is updated in place.
+//     input: The move to make.
+//
+// Returns:
+//     Whether the tetrimino moved.
+template <typename Rules>
+bool try_move(
+    BasicBoard<Rules> const& board,
+    FallingTetrimino& falling,
+    Input input);
+
 inline Tetrimino const& random_tetrimino(Rng& rng)
 {
     return tetriminoes[static_cast<std::size_t>(rng.get_int())];
@@ -62,24 +154,18 @@ enum class State {
     Clearing,
 };
 
-class Tetris {
+// Game logic over state that is stored elsewhere.
+//
+// `Tetris` owns its state and forwards to this. Other layouts can use it
+// directly.
+template <typename Rules> class BasicGameView {
 public:
-    Tetris(Rng rng): rng_(std::move(rng)), state{{random_tetrimino(rng_)}} {}
+    using Board = BasicBoard<Rules>;
+    using GameState = BasicGameState<Rules>;
 
-    bool is_over() const
-    {
-        return state.game_over;
-    }
-
-    Board const& board() const
-    {
-        return board_;
-    }
-
-    FallingTetrimino const& falling_tetrimino() const
-    {
-        return state.falling;
-    }
+    BasicGameView(Board& board, GameState& game_state, Rng& rng):
+        board_{board}, state{game_state}, rng_{rng}
+    {}
 
     void advance(Input input)
     {
@@ -104,21 +190,178 @@ public:
         }
     }
 
+    // Drop the falling tetrimino into a column, skipping the ticks it would
+    // take to fall there.
+    //
+    // The tetrimino is rotated where it is, slid sideways to `column` and
+    // dropped until it lands. Then it locks right away: full lines are
+    // cleared without waiting for `clearing_ticks`, and the next tetrimino
+    // starts falling.
+    //
+    // Args:
+    //     column: Column for the top-left corner of the tetrimino's shape.
+    //     rotation: Rotation to lock the tetrimino with.
+    //
+    // Returns:
+    //     Whether the tetrimino was placed. It isn't when the game is over or
+    //     the rotation or any column on the way is blocked. Lines waiting to
+    //     be cleared are cleared either way; nothing else changes.
+    bool place(int column, geom::Rotation rotation);
+
+    // Lock the falling tetrimino where it would land, such as at a position
+    // found by `PlacementFinder`, skipping the ticks it would take to get
+    // there.
+    //
+    // Args:
+    //     landing: The same tetrimino, somewhere it fits and can't fall any
+    //              further from once waiting lines are cleared.
+    //
+    // Returns:
+    //     Whether the tetrimino was placed. Lines waiting to be cleared are
+    //     cleared either way; nothing else changes.
+    bool place(FallingTetrimino const& landing);
+
 private:
     void apply_input(Input input);
+    bool auto_repeat_allows(Input input);
     void check_for_game_over();
     bool try_drop();
     void lock_tetrimino();
+    void settle();
     void pick_new_tetrimino();
     void mark_cleared_lines();
     void clear_lines();
+    void finish_clearing();
+    void lock_at(FallingTetrimino const& landing);
     State game_tick(Input input);
 
+    Board& board_;
+    GameState& state;
+    Rng& rng_;
+};
+
+extern template class BasicGameView<StandardRules>;
+extern template class BasicGameView<TallRules>;
+extern template class BasicGameView<CompactRules>;
+extern template class BasicGameView<ModernRules>;
+extern template class BasicGameView<Rows32Rules>;
+
+using GameView = BasicGameView<StandardRules>;
+
+// A game that owns its state.
+template <typename Rules> class BasicTetris {
+public:
+    using Board = BasicBoard<Rules>;
+    using GameState = BasicGameState<Rules>;
+    using GameView = BasicGameView<Rules>;
+    using Snapshot = BasicSnapshot<Rules>;
+
+    BasicTetris(Rng rng):
+        rng_(std::move(rng)),
+        state{{random_tetrimino(rng_)}},
+        shown_{state.falling}
+    {}
+
+    bool is_over() const
+    {
+        return state.game_over;
+    }
+
+    Board const& board() const
+    {
+        return board_;
+    }
+
+    FallingTetrimino const& falling_tetrimino() const
+    {
+        return state.falling;
+    }
+
+    // Lines cleared so far.
+    int lines() const
+    {
+        return state.lines;
+    }
+
+    // Whether full lines are waiting to be removed. Inputs are ignored
+    // meanwhile.
+    bool clearing() const
+    {
+        return state.clearing_ticks > 0 or state.cleared_lines != 0;
+    }
+
+    void advance(Input input)
+    {
+        GameView{board_, state, rng_}.advance(input);
+    }
+
+    // See `tetris::ticks_until_update`.
+    std::optional<int> ticks_until_update() const
+    {
+        return tetris::ticks_until_update<Rules>(state);
+    }
+
+    // See `GameView::place`.
+    bool place(int column, geom::Rotation rotation)
+    {
+        return GameView{board_, state, rng_}.place(column, rotation);
+    }
+
+    // See `GameView::place`.
+    bool place(FallingTetrimino const& landing)
+    {
+        return GameView{board_, state, rng_}.place(landing);
+    }
+
+    // Capture the whole game.
+    Snapshot save() const
+    {
+        return {board_, rng_, state};
+    }
+
+    // Go back to a captured game.
+    void restore(Snapshot const& snapshot)
+    {
+        board_ = snapshot.board;
+        rng_ = snapshot.rng;
+        state = snapshot.state;
+        restored_ = true;
+    }
+
+    // Rows that may look different since the last `clear_dirty_rows`: the
+    // rows whose blocks changed, plus the rows the falling tetrimino covered
+    // then and covers now. Everything is dirty after a `restore`.
+    typename Board::RowSet dirty_rows() const
+    {
+        if (restored_) {
+            return Board::all_rows;
+        }
+
+        return board_.dirty_rows() | covered_rows<Rules>(shown_) |
+               covered_rows<Rules>(state.falling);
+    }
+
+    // Start tracking changes from the current state, typically right after
+    // drawing it.
+    void clear_dirty_rows()
+    {
+        board_.clear_dirty_rows();
+        shown_ = state.falling;
+        restored_ = false;
+    }
+
+private:
     Rng rng_;
     Board board_;
     GameState state;
+
+    // The falling tetrimino as of the last `clear_dirty_rows`.
+    FallingTetrimino shown_;
+    bool restored_ = false;
 };
 
+using Tetris = BasicTetris<StandardRules>;
+
 }
 
 #endif
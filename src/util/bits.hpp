@@ -0,0 +1,67 @@
+#ifndef UTIL_BITS_HPP
+#define UTIL_BITS_HPP
+
+#include <cstdint>
+
+#include "unreachable.hpp"
+
+// Bit counting, standing in for C++20's `<bit>`. Compiler builtins are used
+// when available, so that these become single instructions (e.g. `popcnt`,
+// `tzcnt`) on targets that have them.
+
+namespace util {
+
+// Number of set bits.
+inline int popcount(std::uint64_t value)
+{
+    // Without `popcnt`, GCC turns the builtin into a library call on x86,
+    // which is slower than counting inline.
+#if (__has_builtin(__builtin_popcountll) || UTIL_GNUC_PREREQ(3, 4, 0)) &&     \
+    (defined(__POPCNT__) || not(defined(__x86_64__) || defined(__i386__)))
+    return __builtin_popcountll(value);
+#else
+    value -= (value >> 1) & 0x5555'5555'5555'5555;
+    value = (value & 0x3333'3333'3333'3333) +
+            ((value >> 2) & 0x3333'3333'3333'3333);
+    value = (value + (value >> 4)) & 0x0F0F'0F0F'0F0F'0F0F;
+    return static_cast<int>((value * 0x0101'0101'0101'0101) >> 56);
+#endif
+}
+
+// Number of zero bits below the lowest set bit. `value` must not be zero.
+inline int countr_zero(std::uint64_t value)
+{
+#if __has_builtin(__builtin_ctzll) || UTIL_GNUC_PREREQ(3, 4, 0)
+    return __builtin_ctzll(value);
+#else
+    auto count = 0;
+
+    while (not(value & 1u)) {
+        value >>= 1;
+        ++count;
+    }
+
+    return count;
+#endif
+}
+
+// Number of zero bits above the highest set bit. `value` must not be zero.
+inline int countl_zero(std::uint64_t value)
+{
+#if __has_builtin(__builtin_clzll) || UTIL_GNUC_PREREQ(3, 4, 0)
+    return __builtin_clzll(value);
+#else
+    auto count = 0;
+
+    while (not(value & (std::uint64_t{1} << 63))) {
+        value <<= 1;
+        ++count;
+    }
+
+    return count;
+#endif
+}
+
+}
+
+#endif
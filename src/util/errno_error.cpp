@@ -0,0 +1,13 @@
+#include "errno_error.hpp"
+
+#include <cerrno>
+#include <system_error>
+
+namespace util {
+
+void throw_errno(char const* what)
+{
+    throw std::system_error{errno, std::generic_category(), what};
+}
+
+}
@@ -0,0 +1,17 @@
+#ifndef UTIL_ERRNO_ERROR_HPP
+#define UTIL_ERRNO_ERROR_HPP
+
+namespace util {
+
+// Report the failure of a system call that set `errno`.
+//
+// Args:
+//     what: What failed, used as the exception's message.
+//
+// Throws:
+//     std::system_error: Always, with the current `errno`.
+[[noreturn]] void throw_errno(char const* what);
+
+}
+
+#endif
@@ -0,0 +1,15 @@
+#include "file_descriptor.hpp"
+
+#include <unistd.h>
+
+namespace util {
+
+void FileDescriptor::reset()
+{
+    if (fd_ != -1) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+}
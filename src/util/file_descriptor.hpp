@@ -0,0 +1,57 @@
+#ifndef UTIL_FILE_DESCRIPTOR_HPP
+#define UTIL_FILE_DESCRIPTOR_HPP
+
+#include <utility>
+
+namespace util {
+
+// Owns a POSIX file descriptor, closing it on destruction.
+class FileDescriptor {
+public:
+    FileDescriptor() = default;
+
+    explicit FileDescriptor(int fd): fd_{fd} {}
+
+    ~FileDescriptor()
+    {
+        reset();
+    }
+
+    FileDescriptor(FileDescriptor const&) = delete;
+    FileDescriptor& operator=(FileDescriptor const&) = delete;
+
+    FileDescriptor(FileDescriptor&& other) noexcept:
+        fd_{std::exchange(other.fd_, -1)}
+    {}
+
+    FileDescriptor& operator=(FileDescriptor&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            fd_ = std::exchange(other.fd_, -1);
+        }
+
+        return *this;
+    }
+
+    // The descriptor, or -1 if none is owned.
+    int get() const
+    {
+        return fd_;
+    }
+
+    explicit operator bool() const
+    {
+        return fd_ != -1;
+    }
+
+    // Close the owned descriptor, if any.
+    void reset();
+
+private:
+    int fd_ = -1;
+};
+
+}
+
+#endif
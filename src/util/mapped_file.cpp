@@ -0,0 +1,73 @@
+#include "mapped_file.hpp"
+
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "errno_error.hpp"
+#include "file_descriptor.hpp"
+
+namespace util {
+
+MappedFile::MappedFile(std::string const& path)
+{
+    auto fd = FileDescriptor{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+
+    if (not fd) {
+        throw_errno("open failed");
+    }
+
+    struct stat status;
+
+    if (::fstat(fd.get(), &status) == -1) {
+        throw_errno("fstat failed");
+    }
+
+    size_ = static_cast<std::size_t>(status.st_size);
+
+    // Mapping nothing is an error, so an empty file is left unmapped.
+    if (size_ == 0) {
+        return;
+    }
+
+    auto data = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd.get(), 0);
+
+    if (data == MAP_FAILED) {
+        throw_errno("mmap failed");
+    }
+
+    data_ = static_cast<unsigned char const*>(data);
+}
+
+MappedFile::~MappedFile()
+{
+    reset();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept:
+    data_{std::exchange(other.data_, nullptr)},
+    size_{std::exchange(other.size_, 0)}
+{}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other) {
+        reset();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    return *this;
+}
+
+void MappedFile::reset()
+{
+    if (data_) {
+        ::munmap(const_cast<unsigned char*>(data_), size_);
+        data_ = nullptr;
+    }
+}
+
+}
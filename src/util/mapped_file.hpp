@@ -0,0 +1,47 @@
+#ifndef UTIL_MAPPED_FILE_HPP
+#define UTIL_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace util {
+
+// A whole file mapped read-only into memory.
+class MappedFile {
+public:
+    // Args:
+    //     path: The file to map.
+    //
+    // Throws:
+    //     std::system_error: If the file can't be opened or mapped.
+    explicit MappedFile(std::string const& path);
+
+    ~MappedFile();
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // The file's contents, or null if it is empty.
+    unsigned char const* data() const
+    {
+        return data_;
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+private:
+    void reset();
+
+    unsigned char const* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+}
+
+#endif
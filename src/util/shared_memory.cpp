@@ -0,0 +1,116 @@
+#include "shared_memory.hpp"
+
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "errno_error.hpp"
+#include "file_descriptor.hpp"
+
+namespace {
+
+void* map(int fd, std::size_t size, int protection)
+{
+    auto data = ::mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+
+    if (data == MAP_FAILED) {
+        util::throw_errno("mmap failed");
+    }
+
+    return data;
+}
+
+}
+
+namespace util {
+
+SharedMemory::SharedMemory(std::string name, std::size_t size):
+    name_{std::move(name)}, size_{size}
+{
+    ::shm_unlink(name_.c_str());
+
+    auto fd = FileDescriptor{
+        ::shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644)};
+
+    if (not fd) {
+        throw_errno("shm_open failed");
+    }
+
+    owner_ = true;
+
+    if (::ftruncate(fd.get(), static_cast<off_t>(size_)) == -1) {
+        auto error = errno;
+        ::shm_unlink(name_.c_str());
+        throw std::system_error{error, std::generic_category(), "ftruncate"};
+    }
+
+    try {
+        data_ = map(fd.get(), size_, PROT_READ | PROT_WRITE);
+    } catch (...) {
+        ::shm_unlink(name_.c_str());
+        throw;
+    }
+}
+
+SharedMemory::SharedMemory(std::string name): name_{std::move(name)}
+{
+    auto fd = FileDescriptor{::shm_open(name_.c_str(), O_RDONLY, 0)};
+
+    if (not fd) {
+        throw_errno("shm_open failed");
+    }
+
+    struct stat status;
+
+    if (::fstat(fd.get(), &status) == -1) {
+        throw_errno("fstat failed");
+    }
+
+    size_ = static_cast<std::size_t>(status.st_size);
+    data_ = map(fd.get(), size_, PROT_READ);
+}
+
+SharedMemory::~SharedMemory()
+{
+    reset();
+}
+
+SharedMemory::SharedMemory(SharedMemory&& other) noexcept:
+    name_{std::move(other.name_)},
+    data_{std::exchange(other.data_, nullptr)},
+    size_{std::exchange(other.size_, 0)},
+    owner_{std::exchange(other.owner_, false)}
+{}
+
+SharedMemory& SharedMemory::operator=(SharedMemory&& other) noexcept
+{
+    if (this != &other) {
+        reset();
+        name_ = std::move(other.name_);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        owner_ = std::exchange(other.owner_, false);
+    }
+
+    return *this;
+}
+
+void SharedMemory::reset()
+{
+    if (data_) {
+        ::munmap(data_, size_);
+        data_ = nullptr;
+    }
+
+    if (owner_) {
+        ::shm_unlink(name_.c_str());
+        owner_ = false;
+    }
+}
+
+}
@@ -0,0 +1,71 @@
+#ifndef UTIL_SHARED_MEMORY_HPP
+#define UTIL_SHARED_MEMORY_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace util {
+
+// A POSIX shared memory object mapped into this process.
+//
+// The process that creates the object owns its name and removes it on
+// destruction; other processes open it by name while it exists.
+class SharedMemory {
+public:
+    // Create an object, replacing any left over under the same name, and map
+    // it for reading and writing. Its contents start zeroed.
+    //
+    // Args:
+    //     name: The object's name, a slash followed by up to 255 characters
+    //           that aren't slashes.
+    //     size: Size of the object in bytes.
+    //
+    // Throws:
+    //     std::system_error: If the object can't be created or mapped.
+    SharedMemory(std::string name, std::size_t size);
+
+    // Map an existing object, read-only and whole.
+    //
+    // Args:
+    //     name: The name the object was created with.
+    //
+    // Throws:
+    //     std::system_error: If there is no such object or it can't be
+    //                        mapped.
+    explicit SharedMemory(std::string name);
+
+    ~SharedMemory();
+
+    SharedMemory(SharedMemory const&) = delete;
+    SharedMemory& operator=(SharedMemory const&) = delete;
+
+    SharedMemory(SharedMemory&& other) noexcept;
+    SharedMemory& operator=(SharedMemory&& other) noexcept;
+
+    void* data()
+    {
+        return data_;
+    }
+
+    void const* data() const
+    {
+        return data_;
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+private:
+    void reset();
+
+    std::string name_;
+    void* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool owner_ = false;
+};
+
+}
+
+#endif
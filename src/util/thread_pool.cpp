@@ -0,0 +1,213 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// The pool and queue owned by the current thread, if it is a worker.
+thread_local util::ThreadPool const* current_pool = nullptr;
+thread_local std::size_t current_queue = 0;
+
+}
+
+namespace util {
+
+ThreadPool::ThreadPool(unsigned thread_count)
+{
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (auto i = 0u; i < thread_count; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+
+    for (auto i = std::size_t{0}; i < thread_count; ++i) {
+        threads_.emplace_back([this, i] { run(i); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        auto lock = std::lock_guard{state_mutex_};
+        stopping_ = true;
+    }
+
+    work_available_.notify_all();
+
+    for (auto& thread: threads_) {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(Task task)
+{
+    auto index = current_pool == this
+                     ? current_queue
+                     : next_queue_.fetch_add(1) % queues_.size();
+
+    ++pending_;
+
+    // Counted before it is queued, so that a worker taking it right away
+    // never takes `queued_` below zero.
+    {
+        auto lock = std::lock_guard{state_mutex_};
+        ++queued_;
+    }
+
+    {
+        auto& queue = *queues_[index];
+        auto lock = std::lock_guard{queue.mutex};
+        queue.tasks.push_back(std::move(task));
+    }
+
+    work_available_.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    auto lock = std::unique_lock{state_mutex_};
+    all_done_.wait(lock, [&] { return pending_ == 0; });
+
+    if (error_) {
+        std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+}
+
+void ThreadPool::run(std::size_t index)
+{
+    current_pool = this;
+    current_queue = index;
+
+    while (true) {
+        auto task = Task{};
+
+        if (try_pop(index, task)) {
+            run_task(task);
+            continue;
+        }
+
+        auto lock = std::unique_lock{state_mutex_};
+        work_available_.wait(
+            lock,
+            [&] { return queued_ > 0 or stopping_; });
+
+        if (stopping_ and queued_ == 0) {
+            return;
+        }
+    }
+}
+
+bool ThreadPool::try_pop(std::size_t index, Task& task)
+{
+    {
+        auto& own = *queues_[index];
+        auto lock = std::lock_guard{own.mutex};
+
+        if (not own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            --queued_;
+            return true;
+        }
+    }
+
+    for (auto offset = std::size_t{1}; offset < queues_.size(); ++offset) {
+        auto& victim = *queues_[(index + offset) % queues_.size()];
+        auto lock = std::lock_guard{victim.mutex};
+
+        if (not victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --queued_;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::run_task(Task& task)
+{
+    try {
+        task();
+    } catch (...) {
+        auto lock = std::lock_guard{state_mutex_};
+
+        if (not error_) {
+            error_ = std::current_exception();
+        }
+    }
+
+    finish_task();
+}
+
+void ThreadPool::finish_task()
+{
+    if (--pending_ == 0 or helpers_ > 0) {
+        auto lock = std::lock_guard{state_mutex_};
+        all_done_.notify_all();
+    }
+}
+
+void ThreadPool::help_until(std::function<bool()> const& done)
+{
+    auto index = current_pool == this ? current_queue : 0;
+
+    while (not done()) {
+        auto task = Task{};
+
+        if (try_pop(index, task)) {
+            run_task(task);
+            continue;
+        }
+
+        // Every task left is running on another thread. `done` turns true
+        // before the task that makes it so finishes, and finishing wakes us.
+        auto lock = std::unique_lock{state_mutex_};
+        ++helpers_;
+        all_done_.wait(lock, [&] { return queued_ > 0 or done(); });
+        --helpers_;
+    }
+}
+
+TaskGroup::~TaskGroup()
+{
+    pool_.help_until([this] { return pending_ == 0; });
+}
+
+void TaskGroup::submit(ThreadPool::Task task)
+{
+    ++pending_;
+
+    pool_.submit(
+        [this, task = std::move(task)]
+        {
+            try {
+                task();
+            } catch (...) {
+                auto lock = std::lock_guard{error_mutex_};
+
+                if (not error_) {
+                    error_ = std::current_exception();
+                }
+            }
+
+            --pending_;
+        });
+}
+
+void TaskGroup::wait()
+{
+    pool_.help_until([this] { return pending_ == 0; });
+
+    auto lock = std::lock_guard{error_mutex_};
+
+    if (error_) {
+        std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+}
+
+}
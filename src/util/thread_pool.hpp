@@ -0,0 +1,131 @@
+#ifndef UTIL_THREAD_POOL_HPP
+#define UTIL_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace util {
+
+// Work-stealing thread pool.
+//
+// Each worker owns a task queue. Workers take tasks from the back of their own
+// queue and, when it is empty, steal from the front of the others' queues.
+// Tasks submitted from inside a worker go to that worker's queue, so
+// recursively spawned work stays local until someone is idle.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // Start the workers.
+    //
+    // Args:
+    //     thread_count: How many workers to start. Zero means one per
+    //                   hardware thread.
+    explicit ThreadPool(unsigned thread_count = 0);
+
+    // Finishes queued tasks, then joins the workers.
+    ~ThreadPool();
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    // Queue a task to be run by some worker.
+    void submit(Task task);
+
+    // Block until every submitted task has finished.
+    //
+    // If any task threw, the first exception is rethrown here. Tasks must not
+    // call this, since they would wait for themselves; they can wait for the
+    // tasks they submit with a `TaskGroup`.
+    void wait();
+
+    // How many workers there are.
+    std::size_t size() const
+    {
+        return threads_.size();
+    }
+
+private:
+    friend class TaskGroup;
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void run(std::size_t index);
+    bool try_pop(std::size_t index, Task& task);
+    void run_task(Task& task);
+    void finish_task();
+
+    // Run queued tasks on the calling thread until `done` holds, sleeping
+    // while there are none but `done` doesn't hold yet.
+    void help_until(std::function<bool()> const& done);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+
+    // Guards sleeping, waking and the stored exception.
+    std::mutex state_mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable all_done_;
+
+    // Tasks sitting in queues, or about to be. Only incremented with
+    // `state_mutex_` held.
+    std::atomic<std::size_t> queued_{0};
+    // Tasks submitted but not finished yet.
+    std::atomic<std::size_t> pending_{0};
+    std::atomic<std::size_t> next_queue_{0};
+    // Threads in `help_until`, who need to hear about every finished task.
+    std::atomic<std::size_t> helpers_{0};
+    bool stopping_ = false;
+    std::exception_ptr error_;
+};
+
+// Tasks submitted to a pool that can be waited for on their own.
+//
+// Unlike `ThreadPool::wait`, `wait` only waits for this group's tasks, and
+// runs queued tasks of the pool while it does. This lets a task split its work
+// over the pool it runs on and wait for it, without every worker ending up
+// blocked on work that nobody is left to run.
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool): pool_{pool} {}
+
+    // Waits for the group's tasks, dropping their exceptions.
+    ~TaskGroup();
+
+    TaskGroup(TaskGroup const&) = delete;
+    TaskGroup& operator=(TaskGroup const&) = delete;
+    TaskGroup(TaskGroup&&) = delete;
+    TaskGroup& operator=(TaskGroup&&) = delete;
+
+    // Queue a task in the group.
+    void submit(ThreadPool::Task task);
+
+    // Block until every task of the group has finished, helping the pool in
+    // the meantime.
+    //
+    // If any task of the group threw, the first exception is rethrown here.
+    void wait();
+
+private:
+    ThreadPool& pool_;
+    std::atomic<std::size_t> pending_{0};
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+};
+
+}
+
+#endif
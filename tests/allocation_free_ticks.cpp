@@ -0,0 +1,95 @@
+// Check that a steady-state game never allocates, by counting every call to
+// the global allocation functions while ticking, saving and restoring games.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "check.hpp"
+#include "rng.hpp"
+#include "tetris.hpp"
+
+namespace {
+
+std::size_t allocations = 0;
+
+void* counted_allocation(std::size_t size)
+{
+    ++allocations;
+
+    if (auto memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+
+    throw std::bad_alloc{};
+}
+
+}
+
+void* operator new(std::size_t size)
+{
+    return counted_allocation(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return counted_allocation(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+int main()
+{
+    constexpr auto ticks = 500'000;
+    constexpr auto save_every = 1'000;
+    constexpr auto restore_every = 7'919;
+    constexpr auto inputs =
+        static_cast<std::uint32_t>(tetris::Input::HardDrop) + 1;
+
+    auto input_engine = tetris::Pcg32{1};
+    auto game = tetris::Tetris{tetris::Rng{1}};
+    auto snapshot = game.save();
+    auto games = 1;
+
+    auto const before = allocations;
+
+    for (auto tick = 1; tick <= ticks; ++tick) {
+        game.advance(static_cast<tetris::Input>(
+            tetris::bounded_rand(input_engine, inputs)));
+
+        if (game.is_over()) {
+            game = tetris::Tetris{tetris::Rng{
+                static_cast<tetris::Rng::Seed>(++games)}};
+        }
+
+        if (tick % save_every == 0) {
+            snapshot = game.save();
+        }
+
+        if (tick % restore_every == 0) {
+            game.restore(snapshot);
+        }
+    }
+
+    tests::check(allocations == before, "a game tick allocated memory");
+    tests::check(games > 1, "no game ended, so restarts went untested");
+}
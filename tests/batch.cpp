@@ -0,0 +1,61 @@
+// Check that batches of headless games run to the same results every time,
+// including from inside a task of the pool they run on.
+
+#include <cstdint>
+#include <vector>
+
+#include "batch.hpp"
+#include "check.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+std::vector<sim::GameSpec> specs()
+{
+    auto specs = std::vector<sim::GameSpec>{};
+
+    for (auto seed = std::uint32_t{0}; seed < 16; ++seed) {
+        specs.push_back({seed, sim::random_inputs(seed), 20'000});
+    }
+
+    return specs;
+}
+
+std::vector<std::int64_t> ticks(sim::BatchResult const& result)
+{
+    auto ticks = std::vector<std::int64_t>{};
+
+    for (auto const& game: result.games) {
+        ticks.push_back(game.ticks);
+    }
+
+    return ticks;
+}
+
+}
+
+int main()
+{
+    auto pool = util::ThreadPool{1};
+
+    auto empty = sim::run_batch({}, pool);
+    tests::check(
+        empty.report.games_per_second() == 0 and
+            empty.report.ticks_per_second() == 0,
+        "an empty batch has a non-zero rate");
+
+    auto first = sim::run_batch(specs(), pool);
+    tests::check(
+        first.report.ticks > 0 and first.games.size() == 16,
+        "a batch played nothing");
+
+    // With a single worker, waiting for the whole pool here would wait for
+    // this very task.
+    auto nested = sim::BatchResult{};
+    pool.submit([&] { nested = sim::run_batch(specs(), pool); });
+    pool.wait();
+
+    tests::check(
+        ticks(nested) == ticks(first),
+        "the same batch played differently");
+}
@@ -0,0 +1,89 @@
+// Check that every game of a `BatchEnv` plays out exactly like a `Tetris`
+// seeded the same way and given the same inputs, across restarts.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "batch_env.hpp"
+#include "check.hpp"
+#include "observation.hpp"
+#include "rng.hpp"
+#include "tetris.hpp"
+
+namespace {
+
+constexpr auto games = std::size_t{32};
+constexpr auto steps = 20'000;
+constexpr auto seed = tetris::Rng::Seed{7};
+
+bool same(tetris::Observation const& a, tetris::Observation const& b)
+{
+    return a.rows == b.rows and a.tetrimino == b.tetrimino and
+           a.rotation == b.rotation and a.row == b.row and
+           a.column == b.column and a.ticks == b.ticks and
+           a.clearing_ticks == b.clearing_ticks and a.lines == b.lines and
+           a.lock_ticks == b.lock_ticks and
+           a.lock_resets == b.lock_resets and
+           a.held_ticks == b.held_ticks and a.game_over == b.game_over;
+}
+
+}
+
+int main()
+{
+    auto env = tetris::BatchEnv{games, seed};
+    auto references = std::vector<tetris::Tetris>{};
+    auto episodes = std::vector<std::uint32_t>(games, 0);
+
+    for (auto game = std::size_t{0}; game < games; ++game) {
+        references.emplace_back(
+            tetris::Rng{tetris::BatchEnv::episode_seed(seed, game, 0)});
+    }
+
+    auto input_rng = tetris::Pcg32{seed};
+    auto inputs = std::vector<tetris::Input>(games);
+    auto restarts = 0;
+    auto lines = 0;
+
+    for (auto step = 0; step < steps; ++step) {
+        for (auto& input: inputs) {
+            input = static_cast<tetris::Input>(
+                tetris::bounded_rand(input_rng, 6));
+        }
+
+        env.step(inputs);
+
+        for (auto game = std::size_t{0}; game < games; ++game) {
+            auto& reference = references[game];
+            reference.advance(inputs[game]);
+
+            tests::check(
+                env.dones()[game] == reference.is_over(),
+                "a batched game ended on another tick than its reference");
+
+            if (reference.is_over()) {
+                lines += reference.lines();
+                ++restarts;
+                auto episode = ++episodes[game];
+                reference = tetris::Tetris{tetris::Rng{
+                    tetris::BatchEnv::episode_seed(seed, game, episode)}};
+            }
+
+            auto expected = tetris::Observation{};
+            auto actual = tetris::Observation{};
+            tetris::observe(
+                reference.board(),
+                reference.save().state,
+                expected);
+            env.observe(game, actual);
+
+            tests::check(
+                same(actual, expected),
+                "a batched game differs from its reference");
+        }
+    }
+
+    tests::check(restarts > 0, "no batched game ended");
+    tests::check(lines > 0, "no batched game cleared lines");
+}
@@ -0,0 +1,102 @@
+// Check the incremental board hash against a full recomputation after every
+// change seeded games make: locks, line clears and copies between boards.
+
+#include <cstddef>
+#include <cstdint>
+
+#include "agent.hpp"
+#include "board.hpp"
+#include "check.hpp"
+#include "rng.hpp"
+#include "rules.hpp"
+#include "tetris.hpp"
+
+namespace {
+
+template <typename Board> void check_hash(Board const& board)
+{
+    tests::check(
+        board.hash() == board.compute_hash(),
+        "incremental board hash differs from a recomputed one");
+}
+
+// Copy a board row by row and check that the copy hashes the same.
+template <typename Board> void check_copy(Board const& board)
+{
+    auto copy = Board{};
+
+    for (auto row = 0; row < Board::rows; ++row) {
+        auto blocks = typename Board::RowBlocks{};
+
+        for (auto c = 0; c < Board::columns; ++c) {
+            blocks[static_cast<std::size_t>(c)] = board[{row, c}];
+        }
+
+        copy.load_row(row, blocks);
+    }
+
+    check_hash(copy);
+    tests::check(
+        copy.hash() == board.hash(),
+        "a board copied row by row hashes differently");
+}
+
+// Play games tick by tick with random inputs, checking the board after every
+// tick.
+//
+// Returns:
+//     Lines cleared over all games.
+template <typename Rules> int check_random_games()
+{
+    constexpr auto inputs =
+        static_cast<std::uint32_t>(tetris::Input::HardDrop) + 1;
+
+    auto input_engine = tetris::Pcg32{20};
+    auto lines = 0;
+
+    for (auto seed = tetris::Rng::Seed{0}; seed < 50; ++seed) {
+        auto game = tetris::BasicTetris<Rules>{tetris::Rng{seed}};
+
+        while (not game.is_over()) {
+            game.advance(static_cast<tetris::Input>(
+                tetris::bounded_rand(input_engine, inputs)));
+            check_hash(game.board());
+        }
+
+        check_copy(game.board());
+        lines += game.lines();
+    }
+
+    return lines;
+}
+
+// Let the agent play, which clears many more lines, checking the board after
+// every placement.
+//
+// Returns:
+//     Lines cleared.
+int check_agent_game()
+{
+    auto agent = tetris::Agent{tetris::AgentConfig{1}};
+    auto game = tetris::Tetris{tetris::Rng{20}};
+
+    for (auto pieces = 0; pieces < 2'000 and agent.play(game); ++pieces) {
+        check_hash(game.board());
+    }
+
+    check_copy(game.board());
+    return game.lines();
+}
+
+}
+
+int main()
+{
+    // Modern games add hard drops and lock delays, but random inputs top
+    // them out before they clear lines.
+    check_random_games<tetris::ModernRules>();
+    tests::check(
+        check_random_games<tetris::StandardRules>() > 0,
+        "no random standard game cleared a line");
+    tests::check(check_agent_game() > 100, "the agent cleared too few lines");
+}
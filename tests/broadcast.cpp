@@ -0,0 +1,83 @@
+// Check that a viewer following a broadcast keeps an exact copy of the game
+// when the publisher only sends dirty rows, through line clears, keyframes,
+// new games and a restored one.
+
+#include <string>
+
+#include <unistd.h>
+
+#include "broadcast.hpp"
+#include "check.hpp"
+#include "rng.hpp"
+#include "tetris.hpp"
+
+namespace {
+
+constexpr auto ticks = 50'000;
+
+std::string broadcast_name()
+{
+    return "/tetris-test-broadcast-" + std::to_string(getpid());
+}
+
+bool same(tetris::BroadcastViewer const& viewer, tetris::Tetris const& game)
+{
+    for (auto r = 0; r < tetris::Board::rows; ++r) {
+        for (auto c = 0; c < tetris::Board::columns; ++c) {
+            if (viewer.board()[{r, c}] != game.board()[{r, c}]) {
+                return false;
+            }
+        }
+    }
+
+    auto const& shown = viewer.falling_tetrimino();
+    auto const& falling = game.falling_tetrimino();
+
+    return shown.index == falling.index and
+           shown.rotation == falling.rotation and
+           shown.position.row == falling.position.row and
+           shown.position.column == falling.position.column and
+           viewer.lines() == game.lines() and
+           viewer.is_over() == game.is_over();
+}
+
+}
+
+int main()
+{
+    auto publisher = tetris::BroadcastPublisher{broadcast_name()};
+    auto viewer = tetris::BroadcastViewer{broadcast_name()};
+    auto seed = tetris::Rng::Seed{0};
+    auto game = tetris::Tetris{tetris::Rng{seed}};
+    auto inputs = tetris::Pcg32{seed};
+    auto start = game.save();
+    auto lines = 0;
+
+    for (auto tick = 0; tick < ticks; ++tick) {
+        if (game.is_over()) {
+            lines += game.lines();
+            game = tetris::Tetris{tetris::Rng{++seed}};
+        }
+
+        // Going back to an earlier game changes rows without them being
+        // dirty on the board itself, since they weren't when it was saved.
+        if (tick == ticks / 4) {
+            start = game.save();
+        } else if (tick == ticks / 2) {
+            game.restore(start);
+        }
+
+        game.advance(static_cast<tetris::Input>(
+            tetris::bounded_rand(inputs, 5)));
+        publisher.publish(game);
+        viewer.poll();
+
+        tests::check(viewer.synced(), "the viewer never read a keyframe");
+        tests::check(same(viewer, game), "the viewer shows another game");
+
+        // As drawing the game does.
+        game.clear_dirty_rows();
+    }
+
+    tests::check(lines > 0, "no game cleared lines");
+}
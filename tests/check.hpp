@@ -0,0 +1,24 @@
+#ifndef TESTS_CHECK_HPP
+#define TESTS_CHECK_HPP
+
+#include <cstdlib>
+#include <iostream>
+
+namespace tests {
+
+// Fail the test, exiting with an error, unless a condition holds.
+//
+// Args:
+//     condition: What must hold.
+//     message: What is printed when it does not.
+inline void check(bool condition, char const* message)
+{
+    if (not condition) {
+        std::cerr << "check failed: " << message << '\n';
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,125 @@
+// Check that rows written to a dataset read back the same, chunk by chunk and
+// through `find`, so that the XOR-delta and zero-run codec round-trips.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "check.hpp"
+#include "dataset.hpp"
+#include "rng.hpp"
+#include "tetris.hpp"
+
+namespace {
+
+constexpr auto games = std::uint32_t{3};
+constexpr auto ticks_per_game = std::uint32_t{5'000};
+
+std::string dataset_path()
+{
+    return std::filesystem::temp_directory_path() /
+           ("tetris-test-dataset-" + std::to_string(getpid()));
+}
+
+bool same(tetris::DatasetRow const& a, tetris::DatasetRow const& b)
+{
+    return a.game == b.game and a.tick == b.tick and a.board == b.board and
+           a.tetrimino == b.tetrimino and a.rotation == b.rotation and
+           a.row == b.row and a.column == b.column and
+           a.action == b.action and a.reward == b.reward;
+}
+
+// Record games tick by tick, starting a game over under the same id when it
+// ends.
+//
+// Returns:
+//     The rows written, in order.
+std::vector<tetris::DatasetRow> write_games(std::string const& path)
+{
+    auto writer = tetris::DatasetWriter{path};
+    auto inputs = tetris::Pcg32{5};
+    auto rows = std::vector<tetris::DatasetRow>{};
+
+    for (auto id = std::uint32_t{0}; id < games; ++id) {
+        auto seed = tetris::Rng::Seed{id};
+        auto game = tetris::Tetris{tetris::Rng{seed}};
+
+        for (auto tick = std::uint32_t{0}; tick < ticks_per_game; ++tick) {
+            if (game.is_over()) {
+                seed += games;
+                game = tetris::Tetris{tetris::Rng{seed}};
+            }
+
+            auto row = tetris::DatasetRow{};
+            row.game = id;
+            row.tick = tick;
+
+            for (auto r = 0; r < tetris::Board::rows; ++r) {
+                row.board[static_cast<std::size_t>(r)] =
+                    game.board().row_cells(r);
+            }
+
+            auto const& falling = game.falling_tetrimino();
+            row.tetrimino = falling.index;
+            row.rotation = static_cast<std::uint8_t>(falling.rotation);
+            row.row = static_cast<std::int8_t>(falling.position.row);
+            row.column = static_cast<std::int8_t>(falling.position.column);
+            row.action = static_cast<tetris::Input>(
+                tetris::bounded_rand(inputs, 5));
+
+            auto lines = game.lines();
+            writer.advance(id, tick, game, row.action);
+            row.reward = static_cast<float>(game.lines() - lines);
+            rows.push_back(row);
+        }
+    }
+
+    writer.close();
+
+    return rows;
+}
+
+}
+
+int main()
+{
+    auto const path = dataset_path();
+    auto rows = write_games(path);
+    auto reader = tetris::DatasetReader{path};
+
+    tests::check(
+        reader.size() == rows.size() and reader.index().size() > 1,
+        "the dataset holds other rows than written");
+
+    auto chunk = tetris::DatasetChunk{};
+    auto next = std::size_t{0};
+
+    for (auto i = std::size_t{0}; i < reader.index().size(); ++i) {
+        reader.read_chunk(i, chunk);
+
+        for (auto row = std::size_t{0}; row < chunk.size(); ++row) {
+            tests::check(
+                same(chunk.row(row), rows[next++]),
+                "a row read back differs from the one written");
+        }
+    }
+
+    for (auto const& expected: {rows.front(), rows[rows.size() / 2],
+                                rows.back()}) {
+        auto found = reader.find(expected.game, expected.tick);
+        tests::check(
+            found and same(*found, expected),
+            "find returned another row");
+    }
+
+    tests::check(
+        not reader.find(games, 0) and not reader.find(0, ticks_per_game),
+        "find returned a row that was never written");
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,102 @@
+// Check that a dataset writer whose writes fail reports it, keeps reporting
+// it, and shuts down cleanly whether it is closed or just destroyed.
+
+#include <cstddef>
+
+#include "check.hpp"
+#include "dataset.hpp"
+#include "rng.hpp"
+
+namespace {
+
+// Every write to this device fails with ENOSPC.
+constexpr auto full_device = "/dev/full";
+constexpr auto chunks = 3;
+
+void push_chunks(tetris::DatasetWriter& writer)
+{
+    auto row = tetris::DatasetRow{};
+
+    for (auto i = std::size_t{0}; i < chunks * tetris::dataset_chunk_rows;
+         ++i) {
+        row.tick = static_cast<std::uint32_t>(i);
+        writer.push(row);
+    }
+}
+
+void check_close_throws()
+{
+    auto thrown = false;
+
+    try {
+        auto writer = tetris::DatasetWriter{full_device};
+        push_chunks(writer);
+        writer.close();
+    } catch (tetris::DatasetError const&) {
+        thrown = true;
+    }
+
+    tests::check(thrown, "writing to a full device didn't throw");
+}
+
+void check_destroy_after_error()
+{
+    auto writer = tetris::DatasetWriter{full_device};
+
+    try {
+        push_chunks(writer);
+    } catch (tetris::DatasetError const&) {
+    }
+
+    // Destroying `writer` must stop its I/O thread instead of terminating.
+}
+
+bool push_throws(tetris::DatasetWriter& writer, tetris::DatasetRow const& row)
+{
+    try {
+        writer.push(row);
+    } catch (tetris::DatasetError const&) {
+        return true;
+    }
+
+    return false;
+}
+
+// Once a chunk failed to write, every push must report it, rather than rows
+// piling up in memory with the error only seen at `close`.
+void check_pushes_after_error()
+{
+    auto writer = tetris::DatasetWriter{full_device};
+    auto engine = tetris::Pcg32{1};
+    auto row = tetris::DatasetRow{};
+    auto failed = false;
+
+    // Random boards make chunks larger than the stream's buffer, so that
+    // writing them reaches the device.
+    for (auto i = std::size_t{0};
+         not failed and i < chunks * tetris::dataset_chunk_rows;
+         ++i) {
+        for (auto& cells: row.board) {
+            cells = static_cast<tetris::Board::RowBits>(engine());
+        }
+
+        failed = push_throws(writer, row);
+    }
+
+    tests::check(failed, "writing chunks to a full device didn't throw");
+
+    for (auto i = std::size_t{0}; i < tetris::dataset_chunk_rows + 1; ++i) {
+        tests::check(
+            push_throws(writer, row),
+            "a push after a failed write didn't throw");
+    }
+}
+
+}
+
+int main()
+{
+    check_close_throws();
+    check_destroy_after_error();
+    check_pushes_after_error();
+}
@@ -0,0 +1,106 @@
+// Check every board feature against values counted by hand on small boards,
+// so that the per-lane bit tricks of `compute_features` stay honest, and
+// check that batched scores match single ones.
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "board.hpp"
+#include "check.hpp"
+#include "features.hpp"
+
+namespace {
+
+// A board whose bottom rows are drawn with `X` for blocks and `.` for empty
+// ones, top row first.
+tetris::Board board_of(std::vector<std::string> const& picture)
+{
+    auto board = tetris::Board{};
+    auto row = tetris::Board::rows - static_cast<int>(picture.size());
+
+    for (auto const& line: picture) {
+        auto blocks = tetris::Board::RowBlocks{};
+
+        for (auto c = std::size_t{0}; c < blocks.size(); ++c) {
+            blocks[c] = line[c] == 'X' ? tetris::BlockType::I
+                                       : tetris::BlockType::Empty;
+        }
+
+        board.load_row(row++, blocks);
+    }
+
+    return board;
+}
+
+void check_features(
+    tetris::Board const& board,
+    tetris::BoardFeatures const& expected)
+{
+    auto features = tetris::compute_features(board);
+
+    tests::check(
+        features.aggregate_height == expected.aggregate_height,
+        "wrong aggregate height");
+    tests::check(
+        features.max_height == expected.max_height,
+        "wrong max height");
+    tests::check(features.holes == expected.holes, "wrong holes");
+    tests::check(
+        features.rows_with_holes == expected.rows_with_holes,
+        "wrong rows with holes");
+    tests::check(features.bumpiness == expected.bumpiness, "wrong bumpiness");
+    tests::check(
+        features.row_transitions == expected.row_transitions,
+        "wrong row transitions");
+    tests::check(
+        features.column_transitions == expected.column_transitions,
+        "wrong column transitions");
+    tests::check(
+        features.cumulative_wells == expected.cumulative_wells,
+        "wrong cumulative wells");
+}
+
+}
+
+int main()
+{
+    // Every row goes from a wall to empty and back; every column from empty
+    // to the floor.
+    auto empty = tetris::Board{};
+    check_features(empty, {0, 0, 0, 0, 0, 40, 10, 0});
+
+    // Column 1 covers two holes, one in each of the bottom rows. Wells are
+    // column 0 next to that overhang, and columns 4 and 9 at the bottom.
+    auto holes = board_of({
+        ".X........",
+        "..........",
+        "X.XX.XXXX.",
+    });
+    check_features(holes, {10, 3, 2, 2, 7, 46, 12, 3});
+
+    // A four-deep well along the right wall: 1 + 2 + 3 + 4.
+    auto well = board_of({
+        "XXXXXXXXX.",
+        "XXXXXXXXX.",
+        "XXXXXXXXX.",
+        "XXXXXXXXX.",
+    });
+    check_features(well, {36, 4, 0, 0, 4, 40, 10, 10});
+
+    auto evaluator = tetris::LinearEvaluator{};
+    auto features = std::vector<tetris::BoardFeatures>{};
+    auto lines_cleared = std::vector<int>{0, 1, 4};
+    auto scores = std::vector<double>{};
+
+    tetris::compute_features(
+        std::vector<tetris::Board>{empty, holes, well},
+        features);
+    evaluator.score(features, lines_cleared, scores);
+
+    for (auto i = std::size_t{0}; i < features.size(); ++i) {
+        tests::check(
+            scores[i] == evaluator.score(features[i], lines_cleared[i]),
+            "a batched score differs from a single one");
+    }
+}
@@ -0,0 +1,141 @@
+// Check that an export refuses bad sizes before creating anything, and that a
+// reader racing the writer only ever sees whole steps, newest last.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "check.hpp"
+#include "observation.hpp"
+#include "observation_export.hpp"
+
+namespace {
+
+constexpr auto games = std::size_t{64};
+constexpr auto steps = std::uint64_t{20'000};
+
+std::string export_name()
+{
+    return "/tetris-test-observations-" + std::to_string(getpid());
+}
+
+// An observation whose every field tells the step and game it is from, so
+// that one mixing two steps is caught.
+tetris::Observation observation_of(std::uint64_t step, std::size_t game)
+{
+    auto observation = tetris::Observation{};
+    auto value = static_cast<std::int32_t>(step * games + game);
+
+    for (auto& row: observation.rows) {
+        row = static_cast<tetris::Board::RowBits>(value);
+    }
+
+    observation.tetrimino = static_cast<std::uint8_t>(value);
+    observation.rotation = static_cast<std::uint8_t>(value);
+    observation.row = static_cast<std::int8_t>(value);
+    observation.column = static_cast<std::int8_t>(value);
+    observation.ticks = value;
+    observation.clearing_ticks = value;
+    observation.lines = value;
+    observation.lock_ticks = value;
+    observation.lock_resets = value;
+    observation.held_ticks = value;
+    observation.game_over = static_cast<std::uint8_t>(value);
+
+    return observation;
+}
+
+bool same(tetris::Observation const& a, tetris::Observation const& b)
+{
+    return a.rows == b.rows and a.tetrimino == b.tetrimino and
+           a.rotation == b.rotation and a.row == b.row and
+           a.column == b.column and a.ticks == b.ticks and
+           a.clearing_ticks == b.clearing_ticks and a.lines == b.lines and
+           a.lock_ticks == b.lock_ticks and
+           a.lock_resets == b.lock_resets and
+           a.held_ticks == b.held_ticks and a.game_over == b.game_over;
+}
+
+void check_bad_sizes()
+{
+    for (auto frames: {0, -1}) {
+        auto thrown = false;
+
+        try {
+            auto exporter =
+                tetris::ObservationExport{export_name(), games, frames};
+        } catch (tetris::ExportError const&) {
+            thrown = true;
+        }
+
+        tests::check(thrown, "an export without frames didn't throw");
+    }
+
+    auto created = true;
+
+    try {
+        auto reader = tetris::ObservationReader{export_name()};
+    } catch (std::system_error const&) {
+        created = false;
+    }
+
+    tests::check(not created, "a refused export created shared memory");
+}
+
+void check_racing_reader()
+{
+    auto exporter = tetris::ObservationExport{export_name(), games, 2};
+    auto reader = tetris::ObservationReader{export_name()};
+    auto writing = std::atomic<bool>{true};
+
+    auto writer = std::thread{[&]
+    {
+        auto observations = std::vector<tetris::Observation>(games);
+
+        for (auto step = std::uint64_t{1}; step <= steps; ++step) {
+            for (auto game = std::size_t{0}; game < games; ++game) {
+                observations[game] = observation_of(step, game);
+            }
+
+            exporter.write(observations);
+        }
+
+        writing = false;
+    }};
+
+    auto observations = std::vector<tetris::Observation>{};
+    auto last_step = std::uint64_t{0};
+    auto whole = true;
+    auto in_order = true;
+
+    while (writing or last_step < steps) {
+        auto step = reader.read(observations);
+
+        in_order = in_order and step >= last_step;
+        last_step = step;
+
+        for (auto game = std::size_t{0}; step > 0 and game < games; ++game) {
+            whole = whole and
+                    same(observations[game], observation_of(step, game));
+        }
+    }
+
+    writer.join();
+
+    tests::check(whole, "a reader saw a torn step");
+    tests::check(in_order, "a reader went back to an older step");
+}
+
+}
+
+int main()
+{
+    check_bad_sizes();
+    check_racing_reader();
+}
@@ -0,0 +1,129 @@
+// Check that a recorded game, mixing inputs with both kinds of placements,
+// plays back to the same game through the binary format, and that seeking
+// lands on the same games as playing through.
+
+#include <cstdint>
+#include <sstream>
+#include <vector>
+
+#include "check.hpp"
+#include "replay.hpp"
+#include "rng.hpp"
+#include "tetris.hpp"
+
+namespace {
+
+constexpr auto seed = tetris::Rng::Seed{11};
+
+bool same(tetris::Tetris const& a, tetris::Tetris const& b)
+{
+    auto const& x = a.save();
+    auto const& y = b.save();
+
+    return x.board.hash() == y.board.hash() and
+           x.state.falling.index == y.state.falling.index and
+           x.state.falling.position.row == y.state.falling.position.row and
+           x.state.falling.position.column ==
+               y.state.falling.position.column and
+           x.state.falling.rotation == y.state.falling.rotation and
+           x.state.ticks == y.state.ticks and
+           x.state.clearing_ticks == y.state.clearing_ticks and
+           x.state.lines == y.state.lines and
+           x.state.game_over == y.state.game_over;
+}
+
+// Where the falling tetrimino lands if dropped straight down.
+tetris::FallingTetrimino landing_of(tetris::Tetris const& game)
+{
+    auto landing = game.falling_tetrimino();
+    auto below = landing.position + geom::Position{1, 0};
+
+    while (game.board().piece_fits(
+        landing.tetrimino(),
+        below,
+        landing.rotation)) {
+        landing.position = below;
+        below.row += 1;
+    }
+
+    return landing;
+}
+
+}
+
+int main()
+{
+    auto recorder = tetris::Recorder{seed};
+    auto game = tetris::Tetris{tetris::Rng{seed}};
+    auto choices = tetris::Pcg32{seed};
+    auto recorded = std::vector<tetris::Tetris>{};
+
+    while (not game.is_over()) {
+        switch (tetris::bounded_rand(choices, 8)) {
+            case 0: {
+                recorder.place(
+                    game,
+                    static_cast<int>(tetris::bounded_rand(choices, 10)) - 1,
+                    static_cast<geom::Rotation>(
+                        tetris::bounded_rand(choices, 4)));
+                break;
+            }
+            case 1: {
+                recorder.place(game, landing_of(game));
+                break;
+            }
+            default: {
+                recorded.push_back(game);
+                recorder.advance(
+                    game,
+                    static_cast<tetris::Input>(
+                        tetris::bounded_rand(choices, 5)));
+                break;
+            }
+        }
+    }
+
+    recorded.push_back(game);
+
+    auto stream = std::stringstream{};
+    tetris::write_replay(stream, recorder.replay());
+    auto replay = tetris::read_replay(stream);
+
+    tests::check(
+        not replay.placements.empty() and
+            replay.ticks() + 1 ==
+                static_cast<std::int64_t>(recorded.size()),
+        "the replay lost ticks or placements");
+
+    auto player = tetris::Player{replay, 50};
+    tests::check(
+        same(player.game(), recorded.front()),
+        "playback starts elsewhere");
+
+    while (not player.done()) {
+        player.step();
+        tests::check(
+            same(
+                player.game(),
+                recorded[static_cast<std::size_t>(player.tick())]),
+            "playback differs from the recorded game");
+    }
+
+    tests::check(same(player.game(), game), "playback ends elsewhere");
+
+    for (auto tick: {replay.ticks() / 3, std::int64_t{0}, replay.ticks()}) {
+        player.seek(tick);
+        tests::check(
+            same(player.game(), recorded[static_cast<std::size_t>(tick)]),
+            "seeking lands on another game");
+    }
+
+    // Seeking forward before anything was played.
+    auto seeker = tetris::Player{replay, 50};
+    seeker.seek(replay.ticks() / 2);
+    tests::check(
+        same(
+            seeker.game(),
+            recorded[static_cast<std::size_t>(replay.ticks() / 2)]),
+        "seeking ahead lands on another game");
+}
@@ -0,0 +1,90 @@
+// Check SRS rotations by where they put a tetrimino's blocks on the board:
+// spawn to right for T and I, and a T kicked off the left wall.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include "board.hpp"
+#include "check.hpp"
+#include "tetris.hpp"
+#include "tetriminoes.hpp"
+
+namespace {
+
+using Cells = std::array<std::pair<int, int>, 4>;
+
+constexpr auto i_index = std::size_t{0};
+constexpr auto t_index = std::size_t{4};
+
+// The board cells a tetrimino covers, as sorted (row, column) pairs.
+Cells cells_of(tetris::FallingTetrimino const& falling)
+{
+    auto const& layout = falling.tetrimino().layout(falling.rotation);
+    auto cells = Cells{};
+
+    for (auto i = std::size_t{0}; i < cells.size(); ++i) {
+        cells[i] = {
+            falling.position.row + layout.blocks[i].row,
+            falling.position.column + layout.blocks[i].column,
+        };
+    }
+
+    std::sort(cells.begin(), cells.end());
+    return cells;
+}
+
+Cells sorted(Cells cells)
+{
+    std::sort(cells.begin(), cells.end());
+    return cells;
+}
+
+tetris::FallingTetrimino falling_at(std::size_t index, int row, int column)
+{
+    auto falling = tetris::FallingTetrimino{tetris::tetriminoes[index]};
+    falling.position = {row, column};
+    return falling;
+}
+
+}
+
+int main()
+{
+    auto const board = tetris::Board{};
+    auto const rotate = tetris::Input::Rotate;
+
+    // T turns about the centre of its 3x3 box.
+    auto t = falling_at(t_index, 5, 4);
+    tests::check(
+        cells_of(t) == sorted({{{5, 5}, {6, 4}, {6, 5}, {6, 6}}}),
+        "T doesn't spawn pointing up");
+    tests::check(tetris::try_move(board, t, rotate), "T can't rotate");
+    tests::check(
+        cells_of(t) == sorted({{{5, 5}, {6, 5}, {6, 6}, {7, 5}}}),
+        "T doesn't rotate from spawn to right in place");
+
+    // I turns about the centre of its 4x4 box, moving to its third column.
+    auto i = falling_at(i_index, 5, 3);
+    tests::check(
+        cells_of(i) == sorted({{{6, 3}, {6, 4}, {6, 5}, {6, 6}}}),
+        "I doesn't spawn flat on its box's second row");
+    tests::check(tetris::try_move(board, i, rotate), "I can't rotate");
+    tests::check(
+        cells_of(i) == sorted({{{5, 5}, {6, 5}, {7, 5}, {8, 5}}}),
+        "I doesn't rotate from spawn to right in its box's third column");
+
+    // Against the left wall, pointing right, T can't turn to point down in
+    // place and takes the second kick, one column to the right.
+    while (tetris::try_move(board, t, tetris::Input::Left)) {
+    }
+
+    tests::check(
+        cells_of(t) == sorted({{{5, 0}, {6, 0}, {6, 1}, {7, 0}}}),
+        "T doesn't reach the left wall");
+    tests::check(tetris::try_move(board, t, rotate), "T can't kick");
+    tests::check(
+        cells_of(t) == sorted({{{6, 0}, {6, 1}, {6, 2}, {7, 1}}}),
+        "T doesn't kick off the left wall by one column");
+}
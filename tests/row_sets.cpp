@@ -0,0 +1,98 @@
+// Check that row sets cover every row of a board, around the switch from 32-
+// to 64-bit sets.
+
+#include <cstdint>
+#include <type_traits>
+
+#include "board.hpp"
+#include "check.hpp"
+#include "rng.hpp"
+#include "rules.hpp"
+#include "tetris.hpp"
+
+namespace {
+
+template <int board_rows> struct RowsRules: tetris::StandardRules {
+    constexpr static auto rows = board_rows;
+};
+
+template <int rows> using RowSetOf =
+    typename tetris::BasicBoard<RowsRules<rows>>::RowSet;
+
+template <int rows> constexpr auto all_rows_of =
+    tetris::BasicBoard<RowsRules<rows>>::all_rows;
+
+static_assert(std::is_same_v<RowSetOf<31>, std::uint32_t>);
+static_assert(std::is_same_v<RowSetOf<32>, std::uint64_t>);
+static_assert(std::is_same_v<RowSetOf<63>, std::uint64_t>);
+
+static_assert(all_rows_of<31> == 0x7FFF'FFFF);
+static_assert(all_rows_of<32> == 0xFFFF'FFFF);
+static_assert(all_rows_of<33> == 0x1'FFFF'FFFF);
+static_assert(all_rows_of<63> == 0x7FFF'FFFF'FFFF'FFFF);
+
+using Board = tetris::BasicBoard<tetris::Rows32Rules>;
+
+void check_full_board()
+{
+    auto board = Board{};
+    board.fill_rows(Board::all_rows, tetris::BlockType::I);
+
+    tests::check(
+        board.full_rows() == Board::all_rows,
+        "filled rows of a 32-row board aren't all full");
+
+    auto bottom = Board::RowSet{1} << (Board::rows - 1);
+    board.clear_dirty_rows();
+    board.fill_rows(bottom, tetris::BlockType::Empty);
+
+    tests::check(
+        board.dirty_rows() == bottom,
+        "emptying the bottom row of a 32-row board dirtied other rows");
+    tests::check(
+        board.full_rows() == (Board::all_rows & ~bottom),
+        "the bottom row of a 32-row board is still full");
+
+    board.collapse_rows(bottom);
+
+    tests::check(
+        board.full_rows() == (Board::all_rows & ~Board::RowSet{1}),
+        "collapsing the bottom row of a 32-row board lost rows");
+    tests::check(
+        board.row_cells(0) == 0,
+        "collapsing a 32-row board left blocks in the top row");
+}
+
+void check_games()
+{
+    constexpr auto inputs =
+        static_cast<std::uint32_t>(tetris::Input::Nothing) + 1;
+
+    auto input_engine = tetris::Pcg32{32};
+    auto lines = 0;
+
+    for (auto seed = tetris::Rng::Seed{0}; seed < 20; ++seed) {
+        auto game = tetris::BasicTetris<tetris::Rows32Rules>{tetris::Rng{seed}};
+
+        while (not game.is_over()) {
+            game.advance(static_cast<tetris::Input>(
+                tetris::bounded_rand(input_engine, inputs)));
+
+            tests::check(
+                (game.dirty_rows() & ~Board::all_rows) == 0,
+                "a 32-row game dirtied rows past the board");
+        }
+
+        lines += game.save().state.lines;
+    }
+
+    tests::check(lines > 0, "no 32-row game cleared a line");
+}
+
+}
+
+int main()
+{
+    check_full_board();
+    check_games();
+}